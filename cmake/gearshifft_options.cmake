@@ -22,9 +22,13 @@ cmake_dependent_option(
   GEARSHIFFT_BACKEND_FFTW_PTHREADS "Use pthreads parallel FFTW libraries if found" OFF
    "GEARSHIFFT_BACKEND_FFTW" ON
   )
+cmake_dependent_option(
+  GEARSHIFFT_BACKEND_FFTW_MPI "Compile gearshifft_fftw_mpi if MPI and FFTW MPI libraries are found" ON
+  "GEARSHIFFT_BACKEND_FFTW" OFF)
 option(GEARSHIFFT_BACKEND_FFTWWRAPPERS  "Compile gearshifft_fftwwrappers if possible" ON)
 option(GEARSHIFFT_BACKEND_ESSL "Compile gearshifft_esslfftw if possible" ON)
 option(GEARSHIFFT_BACKEND_ARMPL "Compile gearshifft_armplfftw if possible" ON)
+option(GEARSHIFFT_BACKEND_BUILTIN "Compile gearshifft_builtin (in-tree FFT, no external library)" ON)
 
 # backend-disabler
 
@@ -35,6 +39,7 @@ option(GEARSHIFFT_BACKEND_FFTW_ONLY "Disable all other backends" OFF)
 option(GEARSHIFFT_BACKEND_FFTWWRAPPERS_ONLY "Disable all other backends" OFF)
 option(GEARSHIFFT_BACKEND_ESSL_ONLY "Disable all other backends" OFF)
 option(GEARSHIFFT_BACKEND_ARMPL_ONLY "Disable all other backends" OFF)
+option(GEARSHIFFT_BACKEND_BUILTIN_ONLY "Disable all other backends" OFF)
 
 # precisions
 
@@ -85,6 +90,8 @@ if(GEARSHIFFT_BACKEND_CUFFT_ONLY
     GEARSHIFFT_BACKEND_ESSL_ONLY
     OR
     GEARSHIFFT_BACKEND_ARMPL_ONLY
+    OR
+    GEARSHIFFT_BACKEND_BUILTIN_ONLY
     )
   set(GEARSHIFFT_BACKEND_CUFFT ${GEARSHIFFT_BACKEND_CUFFT_ONLY} CACHE BOOL "" FORCE)
   set(GEARSHIFFT_BACKEND_CLFFT ${GEARSHIFFT_BACKEND_CLFFT_ONLY} CACHE BOOL "" FORCE)
@@ -93,4 +100,5 @@ if(GEARSHIFFT_BACKEND_CUFFT_ONLY
   set(GEARSHIFFT_BACKEND_FFTWWRAPPERS ${GEARSHIFFT_BACKEND_FFTWWRAPPERS_ONLY} CACHE BOOL "" FORCE)
   set(GEARSHIFFT_BACKEND_ESSL ${GEARSHIFFT_BACKEND_ESSL_ONLY} CACHE BOOL "" FORCE)
   set(GEARSHIFFT_BACKEND_ARMPL ${GEARSHIFFT_BACKEND_ARMPL_ONLY} CACHE BOOL "" FORCE)
+  set(GEARSHIFFT_BACKEND_BUILTIN ${GEARSHIFFT_BACKEND_BUILTIN_ONLY} CACHE BOOL "" FORCE)
 endif()
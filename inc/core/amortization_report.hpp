@@ -0,0 +1,172 @@
+#ifndef AMORTIZATION_REPORT_HPP_
+#define AMORTIZATION_REPORT_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace gearshifft {
+
+  /**
+   * Compares plan variants of a benchmark (e.g. FFTW rigors) by planning cost
+   * and steady-state execution time.
+   *
+   * A variant with more expensive planning pays off after N executions, if
+   * plan + N*exec is smaller than for the cheaper plans. For each benchmark the
+   * lower envelope of plan + N*exec is reported, i.e. which variant is
+   * recommended for which number of executions.
+   */
+  class AmortizationReport {
+  public:
+
+    /**
+     * Adds a variant of a benchmark.
+     * \param plan Planning time of forward and inverse plan [ms].
+     * \param exec Time of forward and inverse transform [ms].
+     */
+    void add(const std::string& name,
+             const std::string& variant,
+             double plan,
+             double exec) {
+      std::lock_guard<std::mutex> g(mutex_);
+      auto it = std::find_if(benchmarks_.begin(), benchmarks_.end(),
+                             [&name](const Benchmark& b) { return b.name == name; });
+      if(it == benchmarks_.end()) {
+        benchmarks_.push_back(Benchmark{name, {}});
+        it = benchmarks_.end()-1;
+      }
+      it->variants.push_back(Variant{variant, plan, exec});
+    }
+
+    bool empty() const {
+      std::lock_guard<std::mutex> g(mutex_);
+      return benchmarks_.empty();
+    }
+
+    /**
+     * Number of executions after which variant b (more expensive plan) is
+     * faster than variant a in total, infinity if b never pays off.
+     */
+    static double breakEven(double plan_a, double exec_a, double plan_b, double exec_b) {
+      if(plan_b <= plan_a)
+        return exec_b <= exec_a ? 0.0 : std::numeric_limits<double>::infinity();
+      if(exec_b >= exec_a)
+        return std::numeric_limits<double>::infinity();
+      return (plan_b-plan_a)/(exec_a-exec_b);
+    }
+
+    /// prints variants, break-even vs. cheapest plan and recommendations per benchmark
+    void report(std::ostream& os, const std::string& apptitle) const {
+      std::lock_guard<std::mutex> g(mutex_);
+      size_t width = 9;
+      size_t vwidth = 7;
+      for(const auto& b : benchmarks_) {
+        width = std::max(width, b.name.size());
+        for(const auto& v : b.variants)
+          vwidth = std::max(vwidth, v.name.size());
+      }
+
+      std::stringstream ss;
+      ss << "; Planning amortization of " << apptitle
+         << " (plan = fwd+inv planning, exec = fwd+inv transform, mean of warm runs)\n"
+         << std::left << std::setw(static_cast<int>(width)) << "Benchmark"
+         << "  " << std::setw(static_cast<int>(vwidth)) << "Variant" << std::right
+         << std::setw(14) << "Plan [ms]"
+         << std::setw(14) << "Exec [ms]"
+         << std::setw(14) << "Break-even"
+         << "\n";
+
+      for(const auto& b : benchmarks_) {
+        auto variants = b.variants;
+        std::stable_sort(variants.begin(), variants.end(),
+                         [](const Variant& lhs, const Variant& rhs) { return lhs.plan < rhs.plan; });
+        const Variant& cheapest = variants.front();
+        bool first = true;
+        for(const auto& v : variants) {
+          ss << std::left << std::setw(static_cast<int>(width)) << (first ? b.name : "")
+             << "  " << std::setw(static_cast<int>(vwidth)) << v.name << std::right
+             << std::setw(14) << std::setprecision(6) << v.plan
+             << std::setw(14) << v.exec
+             << std::setw(14);
+          if(first)
+            ss << "-";
+          else
+            ss << formatCount(breakEven(cheapest.plan, cheapest.exec, v.plan, v.exec));
+          ss << "\n";
+          first = false;
+        }
+        ss << std::left << std::setw(static_cast<int>(width)) << "" << "  recommended: "
+           << recommendation(variants) << "\n";
+      }
+      ss << "; Break-even = number of executions after which the plan beats the cheapest plan\n";
+      os << ss.str() << std::flush;
+    }
+
+  private:
+    struct Variant {
+      std::string name;
+      double plan;
+      double exec;
+    };
+
+    struct Benchmark {
+      std::string name;
+      std::vector<Variant> variants;
+    };
+
+    mutable std::mutex mutex_;
+    std::vector<Benchmark> benchmarks_;
+
+    static std::string formatCount(double n) {
+      if(std::isinf(n))
+        return "never";
+      std::stringstream ss;
+      ss << static_cast<unsigned long long>(std::ceil(n));
+      return ss.str();
+    }
+
+    /**
+     * Walks the lower envelope of plan + N*exec from N=1 on,
+     * e.g. "rigor=estimate (N<120), rigor=measure (N<40000), rigor=patient".
+     */
+    static std::string recommendation(const std::vector<Variant>& variants) {
+      auto total = [](const Variant& v, double n) { return v.plan + n*v.exec; };
+      size_t current = 0;
+      for(size_t k=1; k<variants.size(); ++k) {
+        if(total(variants[k], 1.0) < total(variants[current], 1.0))
+          current = k;
+      }
+      std::stringstream ss;
+      double n = 1.0;
+      while(true) {
+        size_t next = current;
+        double next_n = std::numeric_limits<double>::infinity();
+        for(size_t k=0; k<variants.size(); ++k) {
+          const double b = breakEven(variants[current].plan, variants[current].exec,
+                                     variants[k].plan, variants[k].exec);
+          if(variants[k].exec < variants[current].exec && b >= n
+             && (b < next_n || (b == next_n && variants[k].exec < variants[next].exec))) {
+            next = k;
+            next_n = b;
+          }
+        }
+        ss << variants[current].name;
+        if(next == current)
+          break;
+        ss << " (N<" << formatCount(next_n) << "), ";
+        current = next;
+        n = next_n;
+      }
+      return ss.str();
+    }
+  };
+
+} // gearshifft
+
+#endif /* AMORTIZATION_REPORT_HPP_ */
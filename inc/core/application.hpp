@@ -1,9 +1,14 @@
 #ifndef APPLICATION_HPP_
 #define APPLICATION_HPP_
 
+#include "amortization_report.hpp"
+#include "layout_sweep_report.hpp"
+#include "padding_advisor.hpp"
 #include "result_benchmark.hpp"
 #include "result_all.hpp"
+#include "sweep_planner.hpp"
 #include "timer_cpu.hpp"
+#include "tuning_table.hpp"
 #include "types.hpp"
 
 #include "gearshifft_version.hpp"
@@ -82,14 +87,74 @@ namespace gearshifft {
       context_created_ = false;
     }
 
+    /// adds the results of all processes (see ContextDefault::gather()) on the root process
     void addRecord(const ResultT& r) {
-      resultAll_.add(r);
+      for(const auto& record : T_Context::gather(r)) {
+        resultAll_.add(record);
 
-      if (resultAll_.size() % DUMP_FREQUENCY == 0) {
-        resultWriter_.update();
+        if (resultAll_.size() % DUMP_FREQUENCY == 0) {
+          resultWriter_.update();
+        }
       }
     }
 
+    SweepPlanner& planner() {
+      return planner_;
+    }
+
+    void startPlanner() {
+      planner_.loadReference(T_Context::options().getPredictFrom(), NR_WARMUP_RUNS);
+    }
+
+    void reportPlanner() {
+      planner_.report(std::cout, T_Context::title(), NR_RUNS);
+    }
+
+    AmortizationReport& amortization() {
+      return amortization_;
+    }
+
+    /// prints planning amortization, if benchmarks were run with several plan variants
+    void reportAmortization() {
+      if(!amortization_.empty())
+        amortization_.report(std::cout, T_Context::title());
+    }
+
+    LayoutSweepReport& layoutSweep() {
+      return layoutSweep_;
+    }
+
+    /// prints transform times per layout, if a buffer layout has been swept
+    void reportLayoutSweep() {
+      if(!layoutSweep_.empty())
+        layoutSweep_.report(std::cout, T_Context::title());
+    }
+
+    PaddingAdvisor& padding() {
+      return padding_;
+    }
+
+    /// prints fastest padded sizes, if benchmarks were run with --advise-padding
+    void reportPadding() {
+      if(!padding_.empty())
+        padding_.report(std::cout, T_Context::title(),
+                        T_Context::options().getPaddingOrigins(),
+                        T_Context::options().getAdvisePadding());
+    }
+
+    TuningTable& tuning() {
+      return tuning_;
+    }
+
+    /// writes tuning table (--tuning-table) and prints best configurations
+    void reportTuning() {
+      const std::string& fname = T_Context::options().getTuningTable();
+      if(fname.empty() || tuning_.empty())
+        return;
+      tuning_.write(fname, T_Context::title());
+      tuning_.report(std::cout, T_Context::title(), fname);
+    }
+
     void startWriter() {
 
       std::time_t now = std::time(nullptr);
@@ -99,6 +164,9 @@ namespace gearshifft {
                        << ",\"NumberWarmRuns\"," << NR_WARM_RUNS
                        << ",\"NumberTotalRuns\"," << NR_RUNS
                        << ",\"ErrorBound\"," << ERROR_BOUND
+                       << ",\"MemoryBudget\"," << T_Context::options().getMemoryBudget()
+                       << ",\"FtzDaz\",\"" << T_Context::options().getFtzDaz() << "\""
+                       << ",\"Validate\",\"" << T_Context::options().getValidationPolicy().str() << "\""
                        << ",\"CurrentTime\"," << now
                        << ",\"CurrentTimeLocal\",\"" << strtok(ctime(&now), "\n") << "\""
                        << ",\"Hostname\",\"" << boost::asio::ip::host_name() << "\""
@@ -121,6 +189,11 @@ namespace gearshifft {
     bool context_created_ = false;
     ResultAllT resultAll_;
     ResultWriterT resultWriter_;
+    SweepPlanner planner_;
+    AmortizationReport amortization_;
+    TuningTable tuning_;
+    PaddingAdvisor padding_;
+    LayoutSweepReport layoutSweep_;
     double timeContextCreate_ = 0.0;
     double timeContextDestroy_ = 0.0;
 
@@ -62,8 +62,14 @@ namespace gearshifft {
         return 0;
       }
 
+      const bool dry_run = Context::options().getDryRun();
+
       AppT::getInstance().createContext();
-      if (!Context::options().getListBenchmarks()) {
+      // results are written by the root process only (e.g. MPI rank 0)
+      const bool write_results = !Context::options().getListBenchmarks() && !dry_run
+                                 && Context::is_root();
+      AppT::getInstance().startPlanner();
+      if (write_results) {
         AppT::getInstance().startWriter();
       }
 
@@ -78,8 +84,18 @@ namespace gearshifft {
                                                   boost_vargv_.data() );
 
       AppT::getInstance().destroyContext();
-      if (!Context::options().getListBenchmarks()) {
+      if (write_results) {
         AppT::getInstance().stopWriter();
+        if (Context::options().getTuningTable().empty()) {
+          AppT::getInstance().reportAmortization();
+        } else {
+          AppT::getInstance().reportTuning();
+        }
+        AppT::getInstance().reportLayoutSweep();
+        AppT::getInstance().reportPadding();
+      }
+      if (dry_run && !Context::options().getListBenchmarks()) {
+        AppT::getInstance().reportPlanner();
       }
       return r;
     }
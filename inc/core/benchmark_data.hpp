@@ -1,6 +1,8 @@
 #ifndef BENCHMARK_DATA_HPP_
 #define BENCHMARK_DATA_HPP_
 
+#include "convolution.hpp"
+#include "parallel.hpp"
 #include "types.hpp"
 
 // http://www.boost.org/doc/libs/1_56_0/doc/html/align/tutorial.html
@@ -14,15 +16,89 @@
 #include <boost/noncopyable.hpp>
 #pragma GCC diagnostic pop
 
+#include <list>
+#include <memory>
+#include <mutex>
 #include <numeric>
+#include <typeindex>
+#include <utility>
 #include <vector>
 #include <cmath>
 
 namespace gearshifft {
 
 /**
- * Singleton test data helper and container.
- * Creates real and complex data on first access or when dimensions have changed.
+ * LRU cache for the test data of all precisions and dimensions.
+ * Data sets are evicted when the total size exceeds the cache limit,
+ * but the most recently requested data set is always kept.
+ */
+  class BenchmarkDataCache : private boost::noncopyable {
+  public:
+    static BenchmarkDataCache& instance() {
+      static BenchmarkDataCache cache;
+      return cache;
+    }
+
+    /**
+     * Returns cached data set or creates a new one by create().
+     * \param bytes Size of the data set to be created.
+     * \param limit Cache limit in bytes.
+     */
+    template<typename T, size_t Dimensions, typename TCreate>
+    std::shared_ptr<const T> get(const std::array<size_t, Dimensions>& extents,
+                                 size_t bytes,
+                                 size_t limit,
+                                 TCreate create) {
+      std::lock_guard<std::mutex> g(mutex_);
+      Key key{std::type_index(typeid(T)), {{0,0,0}}};
+      std::copy(extents.begin(), extents.end(), key.second.begin());
+
+      for(auto it=entries_.begin(); it!=entries_.end(); ++it) {
+        if(it->key == key) {
+          entries_.splice(entries_.begin(), entries_, it); // most recently used
+          ++hits_;
+          return std::static_pointer_cast<const T>(it->data);
+        }
+      }
+      ++misses_;
+      while(!entries_.empty() && bytes_+bytes > limit) {
+        bytes_ -= entries_.back().bytes;
+        entries_.pop_back();
+      }
+      std::shared_ptr<const T> data = create();
+      entries_.push_front(Entry{key, data, bytes});
+      bytes_ += bytes;
+      return data;
+    }
+
+    size_t getHits() const {
+      return hits_;
+    }
+
+    size_t getMisses() const {
+      return misses_;
+    }
+
+  private:
+    using Key = std::pair<std::type_index, std::array<size_t, 3> >;
+    struct Entry {
+      Key key;
+      std::shared_ptr<const void> data;
+      size_t bytes;
+    };
+
+    BenchmarkDataCache() = default;
+
+    std::mutex mutex_;
+    std::list<Entry> entries_;
+    size_t bytes_ = 0;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+  };
+
+/**
+ * Test data helper and container.
+ * Data is generated in parallel and kept in BenchmarkDataCache.
  * Provides check_deviation() for accuracy comparison.
  * \note FFT works with accuracy like O(eps*log(N)).
  * \note max(data)-min(data) should fit into realtypes precision.
@@ -41,10 +117,22 @@ namespace gearshifft {
                                                          alignof(ComplexType)> >;
 
 
-    static const BenchmarkDataT& data(const Extent& extents) {
-      static BenchmarkDataT data;
-      data.init_if_dim_changed(extents);
-      return data;
+    /**
+     * Returns test data for extents, created on first access.
+     * \param cache_limit Total size in bytes of the cached test data sets.
+     */
+    static std::shared_ptr<const BenchmarkDataT> data(const Extent& extents,
+                                                      size_t cache_limit) {
+      const size_t n = std::accumulate(extents.begin(), extents.end(),
+                                       static_cast<size_t>(1),
+                                       std::multiplies<size_t>());
+      return BenchmarkDataCache::instance().get<BenchmarkDataT>(
+        extents,
+        n*sizeof(RealType),
+        cache_limit,
+        [&extents]() {
+          return std::shared_ptr<const BenchmarkDataT>(new BenchmarkDataT(extents));
+        });
     }
 
     size_t size() const {
@@ -53,54 +141,140 @@ namespace gearshifft {
 
     void copyTo(RealVector& vec) const {
       vec.resize(size_);
-      std::copy(data_linear_.begin(), data_linear_.end(), vec.begin());
+      const RealType* in = data_linear_.data();
+      RealType* out = vec.data();
+      parallel::for_chunks(size_, [in, out](size_t begin, size_t end) {
+          std::copy(in+begin, in+end, out+begin);
+        });
     }
 
     void copyTo(ComplexVector& vec) const {
       vec.resize(size_);
-      for( size_t i=0; i<size_; ++i ){
-        vec[i].real(data_linear_[i]);
-        vec[i].imag(0.0);
-      }
+      const RealType* in = data_linear_.data();
+      ComplexType* out = vec.data();
+      parallel::for_chunks(size_, [in, out](size_t begin, size_t end) {
+          for( size_t i=begin; i<end; ++i ){
+            out[i] = ComplexType(in[i]); // imag = 0
+          }
+        });
     }
 
     // deviation = sample standard deviation
+    // norm = scaling of the unnormalized round trip (<=0: number of elements)
     template<bool Normalize, typename TVector>
     void check_deviation(double& deviation,
                          size_t& mismatches,
                          const TVector& data,
-                         double error_bound) const {
-      double diff_sum = 0;
-      double diff;
-      for( size_t i=0; i<size_; ++i ){
-        diff = sub<Normalize>(data, i);
-        if(std::isnan(diff) || diff > error_bound)
-          ++mismatches;
-        diff_sum += diff*diff;
-      }
-      deviation = sqrt(diff_sum/(size_-1.0));
+                         double error_bound,
+                         double norm = 0.0) const {
+      auto sums = deviation_sums<Normalize>(data, size_,
+                                            [](size_t k) { return k; },
+                                            input(),
+                                            error_bound, norm);
+      deviation = sqrt(sums.first/(size_-1.0));
+      mismatches += sums.second;
+    }
+
+    // deviation = sample standard deviation of the elements given by indices
+    template<bool Normalize, typename TVector>
+    void check_deviation(double& deviation,
+                         size_t& mismatches,
+                         const TVector& data,
+                         double error_bound,
+                         const std::vector<size_t>& indices,
+                         double norm = 0.0) const {
+      const size_t* idx = indices.data();
+      auto sums = deviation_sums<Normalize>(data, indices.size(),
+                                            [idx](size_t k) { return idx[k]; },
+                                            input(),
+                                            error_bound, norm);
+      deviation = sqrt(sums.first/(indices.size()-1.0));
+      mismatches += sums.second;
+    }
+
+    /**
+     * Deviation of the elements given by indices from the direct (circular)
+     * convolution of the test data with the ConvolutionKernel.
+     */
+    template<bool Normalize, typename TVector>
+    void check_convolution(double& deviation,
+                           size_t& mismatches,
+                           const TVector& data,
+                           double error_bound,
+                           const std::vector<size_t>& indices,
+                           double norm = 0.0) const {
+      const size_t* idx = indices.data();
+      const ConvolutionKernel<RealType, Dimensions> kernel(extents_);
+      const RealType* in = data_linear_.data();
+      auto sums = deviation_sums<Normalize>(data, indices.size(),
+                                            [idx](size_t k) { return idx[k]; },
+                                            [&kernel, in](size_t i) { return kernel.convolve(in, i); },
+                                            error_bound, norm);
+      deviation = sqrt(sums.first/(indices.size()-1.0));
+      mismatches += sums.second;
     }
 
   private:
 
+    using Sums = std::pair<double, size_t>; // sum of squared differences, mismatches
+
+    /// expected value of element i of the round trip
+    auto input() const {
+      const RealType* in = data_linear_.data();
+      return [in](size_t i) { return static_cast<double>(in[i]); };
+    }
+
+    /**
+     * Parallel reduction over count elements, index(k) gives the k-th element,
+     * expected(i) the reference value of element i.
+     */
+    template<bool Normalize, typename TVector, typename TIndex, typename TExpected>
+    Sums deviation_sums(const TVector& data,
+                        size_t count,
+                        TIndex index,
+                        TExpected expected,
+                        double error_bound,
+                        double norm) const {
+      const double scale = 1.0/(norm > 0.0 ? norm : static_cast<double>(size_));
+      return parallel::reduce(
+        count,
+        Sums(0.0, 0),
+        [&](size_t begin, size_t end) {
+          double diff_sum = 0;
+          size_t nmismatches = 0;
+          for( size_t k=begin; k<end; ++k ){
+            const size_t i = index(k);
+            const double diff = sub<Normalize>(data, i, expected(i), scale);
+            // branch-free, true for diff>error_bound and nan
+            nmismatches += static_cast<size_t>( !(diff <= error_bound) );
+            diff_sum += diff*diff;
+          }
+          return Sums(diff_sum, nmismatches);
+        },
+        [](const Sums& a, const Sums& b) {
+          return Sums(a.first+b.first, a.second+b.second);
+        });
+    }
+
     template<bool Normalize>
-    constexpr double sub(const ComplexVector& vector, size_t i) const {
-      return Normalize ? 1.0/size_ * (vector[i].real()) - static_cast<double>(data_linear_[i]) : static_cast<double>( vector[i].real() - data_linear_[i] );
+    constexpr double sub(const ComplexVector& vector, size_t i, double expected, double scale) const {
+      return Normalize ? scale * (vector[i].real()) - expected : static_cast<double>(vector[i].real()) - expected;
     }
 
     template<bool Normalize>
-    constexpr double sub(const RealVector& vector, size_t i) const {
-      return Normalize ? 1.0/size_ * (vector[i]) - static_cast<double>(data_linear_[i]) : static_cast<double>( vector[i] - data_linear_[i] );
+    constexpr double sub(const RealVector& vector, size_t i, double expected, double scale) const {
+      return Normalize ? scale * (vector[i]) - expected : static_cast<double>(vector[i]) - expected;
     }
 
-    void init_if_dim_changed(const Extent& extents) {
-      if(extents_ == extents) // nothing changed
-        return;
-      extents_ = extents;
-      size_ = std::accumulate(extents_.begin(), extents_.end(), 1, std::multiplies<size_t>());
+    explicit BenchmarkData(const Extent& extents)
+      : extents_(extents),
+        size_(std::accumulate(extents.begin(), extents.end(),
+                              static_cast<size_t>(1),
+                              std::multiplies<size_t>())) {
 
-      // allocate variables for all test cases
       data_linear_.resize(size_);
+      RealType* out = data_linear_.data();
+      const size_t n = size_;
 
       const size_t limit16 = 1<<15;
       if(std::is_same<RealType, float16>::value && size_ > limit16) {
@@ -108,28 +282,27 @@ namespace gearshifft {
         // (y[0] of FFT(x) is sum of input values)
         // Overflow leads to nan or inf values and iFFT(FFT()) cannot be validated
         // This method still leads to nan's when size_ >= (1<<20)
-        for( size_t i=0; i<size_; ++i )
-        {
-          if( i%(size_/limit16)==0 )
-            data_linear_[i] = 0.1;
-          else
-            data_linear_[i] = 0.0;
-        }
+        const size_t stride = size_/limit16;
+        parallel::for_chunks(n, [out, stride](size_t begin, size_t end) {
+            for( size_t i=begin; i<end; ++i )
+            {
+              out[i] = static_cast<RealType>( i%stride==0 ? 0.1 : 0.0 );
+            }
+          });
       } else {
-        for( size_t i=0; i<size_; ++i )
-        {
-          data_linear_[i] = 0.125*(i&7);
-        }
+        // branch-free, so the loop can be vectorized
+        parallel::for_chunks(n, [out](size_t begin, size_t end) {
+            for( size_t i=begin; i<end; ++i )
+            {
+              out[i] = static_cast<RealType>( 0.125*(i&7) );
+            }
+          });
       }
-
     }
 
-    BenchmarkData() = default;
-    ~BenchmarkData() = default;
-
   private:
     RealVector data_linear_;
-    Extent extents_ = {{0}};
+    Extent extents_;
     size_t size_ = 0;
 
   };
@@ -5,6 +5,9 @@
 
 #include "application.hpp"
 #include "benchmark_data.hpp"
+#include "denormals.hpp"
+#include "timer_cpu.hpp"
+#include "traits.hpp"
 #include "types.hpp"
 
 #pragma GCC diagnostic push
@@ -13,7 +16,14 @@
 #include <boost/test/included/unit_test.hpp> // Single-header usage variant
 #pragma GCC diagnostic pop
 
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <numeric>
+#include <sstream>
 #include <type_traits>
+#include <utility>
+#include <vector>
 #include <cmath>
 
 namespace gearshifft {
@@ -41,36 +51,203 @@ namespace gearshifft {
     static_assert(NDim<=3,"NDim<=3");
 
     void operator()(const T_Extents& extents) {
-      const auto& dataset = BenchmarkData<T_Precision,NDim>::data(extents);
+      ResultT result = makeResult(extents);
+
+      const BenchmarkPrediction prediction = predict(extents);
+      const std::string skip = preflight(prediction);
+
+      if(T_Context::options().getDryRun()) {
+        std::stringstream name;
+        name << T_Context::title() << "/" << ToString<T_Precision>::value()
+             << "/" << extents << "/" << T_FFT_Wrapper::Title;
+        ApplicationT::getInstance().planner().add(name.str(), prediction, skip);
+        return;
+      }
+
+      if(!skip.empty()) {
+        std::stringstream msg;
+        msg << "predicted " << prediction.total_bytes() << " bytes"
+            << ", host " << prediction.host << " bytes"
+            << ", " << prediction.time << " s";
+        result.setSkipped(skip, msg.str());
+        BOOST_TEST_MESSAGE( "Skipped: " << skip << " " << msg.str() );
+        ApplicationT::getInstance().addRecord(result);
+        return;
+      }
+
+      // test data is generated or taken from cache
+      TimerCPU timer;
+      timer.startTimer();
+      const auto dataset = BenchmarkData<T_Precision,NDim>::data(
+        extents, T_Context::options().getDataCacheLimit());
 
       VectorT data_buffer;
-      dataset.copyTo(data_buffer);
+      dataset->copyTo(data_buffer);
       assert(data_buffer.data());
+      // added to the first run of the benchmark
+      double time_generate = timer.stopTimer();
 
-      auto fft = T_FFT_Wrapper();
+      // each client variant (e.g. plan rigor) with and/or without flushing denormals
+      const auto ftz_modes = ftzModes();
+      auto variants = T_FFT_Wrapper::template variants<T_Precision, NDim>();
+      if(variants.empty())
+        variants.emplace_back();
+      // number of variants per group, only variants of the same transform are compared
+      std::map<std::string, size_t> groups;
+      for(const auto& variant : variants)
+        ++groups[T_FFT_Wrapper::template variant_group<T_Precision, NDim>(variant)];
+
+      const bool tuning = !T_Context::options().getTuningTable().empty();
+      const bool padding = T_Context::options().getAdvisePadding() > 0.0;
+      std::string error;
+      bool first = true;
+      // transform time of the best variant so far per group and ftz mode, for pruning
+      std::map<std::string, std::vector<double> > best_of_group;
+      for(const auto& variant : variants) {
+        T_FFT_Wrapper::template select_variant<T_Precision, NDim>(variant);
+        const std::string group = T_FFT_Wrapper::template variant_group<T_Precision, NDim>(variant);
+        const bool compare_plans = groups[group] > 1;
+        auto& best = best_of_group[group];
+        best.resize(ftz_modes.size(), 0.0);
+        const std::string unsupported = T_FFT_Wrapper::template unsupported<T_Precision, NDim>(extents);
+        for(size_t m = 0; m < ftz_modes.size(); ++m) {
+          const auto& mode = ftz_modes[m];
+          ResultT result_variant = first ? result : makeResult(extents);
+          const std::string label = variantLabel(variant, mode.first);
+          result_variant.setVariant(label);
+          first = false;
+          if(!unsupported.empty()) {
+            result_variant.setSkipped("unsupported", unsupported);
+            ApplicationT::getInstance().addRecord(result_variant);
+            continue;
+          }
+          std::string error_variant = run(result_variant, *dataset, data_buffer, extents,
+                                          mode.second, time_generate, best[m]);
+          time_generate = 0.0;
+          const auto times = meanTimes(result_variant);
+          if(error_variant.empty() && !result_variant.isSkipped()) {
+            if(best[m] <= 0.0 || times.second < best[m])
+              best[m] = times.second;
+            if(compare_plans && !tuning)
+              addAmortization(extents, group, variant, mode.first, times);
+            if(padding)
+              addPadding(result_variant, label, times);
+          }
+          if(error_variant.empty())
+            addLayoutSweep(extents, variant, label, result_variant, times);
+          if(tuning)
+            addTuning(result_variant, label, times);
+          if(error.empty())
+            error = error_variant;
+        }
+      }
+      T_FFT_Wrapper::template select_variant<T_Precision, NDim>("");
+
+      if(!error.empty()) {
+        BOOST_FAIL( error );
+      }
+    }
+
+  private:
+
+    /// FTZ/DAZ modes of the benchmark runs: label of the mode and whether denormals are flushed
+    static std::vector<std::pair<std::string, bool> > ftzModes() {
+      const auto ftz = denormals::toMode(T_Context::options().getFtzDaz());
+      if(ftz == denormals::Mode::Both)
+        return { {"ftz-daz=off", false}, {"ftz-daz=on", true} };
+      return { {"", ftz == denormals::Mode::On} };
+    }
+
+    /// variant as written to the result file, e.g. "rigor=patient;ftz-daz=on"
+    static std::string variantLabel(const std::string& variant, const std::string& ftz_mode) {
+      if(ftz_mode.empty())
+        return variant;
+      return variant + (variant.empty() ? "" : ";") + ftz_mode;
+    }
+
+    ResultT makeResult(const T_Extents& extents) const {
       ResultT result;
       result.template init<T_FFT_Wrapper::IsComplex,
                            T_FFT_Wrapper::IsInplace,
                            T_Precision >
-                       (extents);
+                       (extents, T_FFT_Wrapper::Title);
+      return result;
+    }
 
-      int r;
+    /**
+     * Runs NR_RUNS repetitions of the benchmark and adds the result record.
+     * \param flush_denormals Sets FTZ/DAZ for benchmark and worker threads.
+     * \param time_generate Time of test data generation, added to the first run.
+     * \param best Transform time of the best variant so far (0 = none), the
+     *             benchmark is pruned after the first warm run if it is clearly slower.
+     * \return Error message, empty on success.
+     */
+    std::string run(ResultT& result,
+                    const BenchmarkData<T_Precision,NDim>& dataset,
+                    VectorT& data_buffer,
+                    const T_Extents& extents,
+                    bool flush_denormals,
+                    double time_generate,
+                    double best) const {
+      auto fft = T_FFT_Wrapper();
+      const bool flush_previous = denormals::getFlushDenormals();
+      denormals::setFlushDenormalsAllThreads(flush_denormals);
+
+      std::string error;
+      int r = 0;
       try {
         const double error_bound = ERROR_BOUND<0.0 ? ErrorBound<T_Precision>()() : ERROR_BOUND;
+        const auto& validation = T_Context::options().getValidationPolicy();
+        const double prune = T_Context::options().getPruneFactor();
+        const double norm = T_FFT_Wrapper::template normalization<T_Precision, NDim>(extents);
+        // subnormals are only counted when FTZ/DAZ is studied, the input is the same in every run
+        const bool count_subnormals = denormals::toMode(T_Context::options().getFtzDaz()) != denormals::Mode::Off;
+        double subnormals_input = 0.0;
         for(r = 0; r < NR_RUNS; ++r)
         {
           result.setRun(r);
+          TimerCPU timer;
+          timer.startTimer();
           dataset.copyTo(data_buffer);
+          result.setValue(RecordType::DataPreparation,
+                          timer.stopTimer() + (r==0 ? time_generate : 0.0));
+          if(count_subnormals && r == 0)
+            subnormals_input = static_cast<double>(denormals::countSubnormals(data_buffer));
+          result.setValue(RecordType::SubnormalsInput, subnormals_input);
           fft(result, data_buffer, extents);
+          if(count_subnormals)
+            result.setValue(RecordType::SubnormalsOutput,
+                            static_cast<double>(denormals::countSubnormals(data_buffer)));
 
           double deviation = 0.0; // sample standard deviation
           size_t mismatches = 0; // nr of mismatches
+          size_t validated = 0; // nr of compared elements
           // compute deviation and mismatches
-          dataset.template check_deviation<!T_FFT_Normalized::value>
-            (deviation, mismatches, data_buffer, error_bound);
+          if(is_convolution<T_FFT_Wrapper>::value) {
+            // direct convolution of all elements (or a strided subset of large data)
+            std::vector<size_t> indices;
+            if(validation.sampled())
+              indices = validation.sample(dataset.size(), r);
+            else if(validation.validates(r, NR_RUNS))
+              indices = convolutionIndices(extents);
+            if(!indices.empty())
+              dataset.template check_convolution<!T_FFT_Normalized::value>
+                (deviation, mismatches, data_buffer, error_bound, indices, norm);
+            validated = indices.size();
+          } else if(validation.sampled()) {
+            const auto indices = validation.sample(dataset.size(), r);
+            dataset.template check_deviation<!T_FFT_Normalized::value>
+              (deviation, mismatches, data_buffer, error_bound, indices, norm);
+            validated = indices.size();
+          } else if(validation.validates(r, NR_RUNS)) {
+            dataset.template check_deviation<!T_FFT_Normalized::value>
+              (deviation, mismatches, data_buffer, error_bound, norm);
+            validated = dataset.size();
+          }
 
           result.setValue(RecordType::Deviation, deviation);
           result.setValue(RecordType::Mismatches, static_cast<double>(mismatches));
+          result.setValue(RecordType::Validated, static_cast<double>(validated));
 
           if(std::isnan(deviation) || deviation>error_bound) {
             std::stringstream msg;
@@ -80,14 +257,197 @@ namespace gearshifft {
             result.setError(r, msg.str());
             throw std::runtime_error(msg.str());
           }
+
+          if(r == ApplicationT::NR_WARMUP_RUNS && r+1 < NR_RUNS && prune > 0.0 && best > 0.0) {
+            const double time = result.getValue(RecordType::FFT) + result.getValue(RecordType::FFTInv);
+            if(time > prune*best) {
+              std::stringstream msg;
+              msg << "transform " << time << " ms > " << prune << " x " << best << " ms of best variant";
+              result.setSkipped("pruned", msg.str());
+              break;
+            }
+          }
         }
       } catch(const std::runtime_error& e) {
         result.setError(r, e.what());
-        ApplicationT::getInstance().addRecord(result);
-        BOOST_FAIL( e.what() );
+        error = e.what();
       }
 
+      denormals::setFlushDenormalsAllThreads(flush_previous);
       ApplicationT::getInstance().addRecord(result);
+      return error;
+    }
+
+    /**
+     * Mean planning and transform time [ms] of the warm runs which have been
+     * completed (pruned: first warm run, error: runs before the error).
+     */
+    std::pair<double, double> meanTimes(ResultT& result) const {
+      int end = NR_RUNS;
+      if(result.isSkipped())
+        end = std::min(NR_RUNS, ApplicationT::NR_WARMUP_RUNS+1);
+      else if(result.hasError())
+        end = result.getErrorRun();
+      const int begin = end > ApplicationT::NR_WARMUP_RUNS ? ApplicationT::NR_WARMUP_RUNS : 0;
+      double plan = 0.0;
+      double exec = 0.0;
+      for(int r = begin; r < end; ++r) {
+        result.setRun(r);
+        plan += result.getValue(RecordType::PlanInitFwd) + result.getValue(RecordType::PlanInitInv);
+        exec += result.getValue(RecordType::FFT) + result.getValue(RecordType::FFTInv);
+      }
+      if(end > begin) {
+        plan /= end-begin;
+        exec /= end-begin;
+      }
+      return std::make_pair(plan, exec);
+    }
+
+    /// adds a plan variant to the amortization report
+    void addAmortization(const T_Extents& extents,
+                         const std::string& group,
+                         const std::string& variant,
+                         const std::string& ftz_mode,
+                         const std::pair<double, double>& times) const {
+      std::stringstream name;
+      name << ToString<T_Precision>::value() << "/" << extents << "/" << T_FFT_Wrapper::Title;
+      if(!group.empty())
+        name << "/" << group;
+      if(!ftz_mode.empty())
+        name << "/" << ftz_mode;
+      ApplicationT::getInstance().amortization().add(name.str(), variant, times.first, times.second);
+    }
+
+    /// adds a variant to the layout sweep report, if its layout is swept (e.g. FFTW --pad-sweep)
+    void addLayoutSweep(const T_Extents& extents,
+                        const std::string& variant,
+                        const std::string& label,
+                        const ResultT& result,
+                        const std::pair<double, double>& times) const {
+      const std::string layout = T_FFT_Wrapper::template variant_sweep<T_Precision, NDim>(variant);
+      if(layout.empty())
+        return;
+      std::stringstream name;
+      name << ToString<T_Precision>::value() << "/" << extents << "/" << T_FFT_Wrapper::Title;
+      ApplicationT::getInstance().layoutSweep().add(name.str(),
+                                                    LayoutSweepReport::remove_token(label, layout),
+                                                    layout,
+                                                    times.second,
+                                                    static_cast<size_t>(result.getValue(RecordType::DevBufferSize)),
+                                                    result.isSkipped());
+    }
+
+    /// adds a benchmark of an original or padded extent to the padding advice (--advise-padding)
+    void addPadding(const ResultT& result,
+                    const std::string& label,
+                    const std::pair<double, double>& times) const {
+      std::stringstream name;
+      name << ToString<T_Precision>::value() << "/" << T_FFT_Wrapper::Title;
+      if(!label.empty())
+        name << "/" << label;
+      const auto e = result.getExtents();
+      ApplicationT::getInstance().padding().add(name.str(),
+                                                std::vector<size_t>(e.begin(), e.begin()+NDim),
+                                                times.second,
+                                                static_cast<size_t>(result.getValue(RecordType::DevBufferSize)));
+    }
+
+    /// adds a configuration to the tuning table (--tuning-table)
+    void addTuning(const ResultT& result,
+                   const std::string& config,
+                   const std::pair<double, double>& times) const {
+      TuningTable::Entry entry;
+      entry.precision = result.getPrecision();
+      entry.complex = result.isComplex();
+      entry.dim = result.getDim();
+      entry.extents = result.getExtents();
+      entry.placement = result.isInplace() ? "Inplace" : "Outplace";
+      entry.config = config.empty() ? "default" : config;
+      entry.plan = times.first;
+      entry.time = times.second;
+      entry.status = result.isSkipped() ? "pruned" : result.hasError() ? "error" : "ok";
+      ApplicationT::getInstance().tuning().add(entry);
+    }
+
+    /**
+     * Predicts memory and runtime before any benchmark data is allocated.
+     * Host memory = test data + data buffer + client buffers (if in host memory).
+     * The runtime is the sum of the predicted runtimes of all variants and FTZ/DAZ modes.
+     */
+    BenchmarkPrediction predict(const T_Extents& extents) const {
+      const size_t n = std::accumulate(extents.begin(), extents.end(),
+                                       static_cast<size_t>(1),
+                                       std::multiplies<size_t>());
+      BenchmarkPrediction prediction;
+      prediction.host = n * sizeof(T_Precision)
+                      + n * sizeof(typename VectorT::value_type);
+      // largest footprint of the client variants (e.g. strided layouts)
+      auto variants = T_FFT_Wrapper::template variants<T_Precision, NDim>();
+      if(variants.empty())
+        variants.emplace_back();
+      const auto ftz_modes = ftzModes();
+      prediction.from_reference = true;
+      for(const auto& variant : variants) {
+        T_FFT_Wrapper::template select_variant<T_Precision, NDim>(variant);
+        if(!T_FFT_Wrapper::template unsupported<T_Precision, NDim>(extents).empty())
+          continue; // variant is skipped
+        for(const auto& mode : ftz_modes) {
+          bool from_reference = false;
+          prediction.time += ApplicationT::getInstance().planner().predictTime(
+            ToString<T_Precision>::value(),
+            T_FFT_Wrapper::Title,
+            variantLabel(variant, mode.first),
+            extents,
+            NR_RUNS,
+            from_reference);
+          prediction.from_reference &= from_reference;
+        }
+        try {
+          auto footprint = T_FFT_Wrapper::template footprint<T_Precision>(extents);
+          if(footprint.allocation >= prediction.backend) {
+            prediction.backend = footprint.allocation;
+            prediction.transfer = footprint.transfer;
+            prediction.host_resident = footprint.host_resident;
+          }
+        } catch(const std::runtime_error&) {
+          // client rejects extents by itself, error will be recorded by the benchmark run
+        }
+      }
+      T_FFT_Wrapper::template select_variant<T_Precision, NDim>("");
+      if(prediction.host_resident)
+        prediction.host += prediction.backend;
+      return prediction;
+    }
+
+    /**
+     * Elements validated against the direct convolution, all elements unless
+     * the direct convolution exceeds ConvolutionKernel::DirectLimit multiply-adds.
+     */
+    std::vector<size_t> convolutionIndices(const T_Extents& extents) const {
+      const ConvolutionKernel<T_Precision, NDim> kernel(extents);
+      const size_t n = kernel.size();
+      const size_t step = (kernel.direct_cost() + ConvolutionKernel<T_Precision, NDim>::DirectLimit - 1)
+                          / ConvolutionKernel<T_Precision, NDim>::DirectLimit;
+      std::vector<size_t> indices;
+      indices.reserve(n/step + 1);
+      for(size_t i = 0; i < n; i += step)
+        indices.push_back(i);
+      return indices;
+    }
+
+    /**
+     * Checks prediction against memory budget and sweep filters.
+     * \return Reason to skip the benchmark, empty if benchmark can be run.
+     */
+    std::string preflight(const BenchmarkPrediction& prediction) const {
+      const auto& options = T_Context::options();
+      if(prediction.host > options.getMemoryBudget())
+        return "memory";
+      if(options.getMaxBytes() > 0 && prediction.total_bytes() > options.getMaxBytes())
+        return "max-bytes";
+      if(options.getMaxPredictedTime() > 0.0 && prediction.time > options.getMaxPredictedTime())
+        return "max-predicted-time";
+      return "";
     }
   };
 
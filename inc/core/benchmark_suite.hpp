@@ -36,6 +36,8 @@ namespace gearshifft {
       template<typename FFT>
       void operator()(FFT) {
         static_assert( has_title<FFT>::value, "FFT Implementation has no static title method.");
+        if(!FFT::template enabled<T_Precision, std::tuple_size<T_Extents>::value>())
+          return;
         using BenchmarkExecutorT = BenchmarkExecutor<T_Context,
                                                      FFT,
                                                      T_FFT_Normalized,
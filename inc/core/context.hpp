@@ -5,6 +5,7 @@
 #include <boost/core/noncopyable.hpp>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 namespace gearshifft {
 
@@ -39,6 +40,20 @@ namespace gearshifft {
     void destroy() {
     }
 
+    /// results are written by this process (benchmarks run by several processes, e.g. MPI)
+    static bool is_root() {
+      return true;
+    }
+
+    /**
+     * Results of a benchmark of all processes to be added on the root process,
+     * empty on the other processes. Called by every process for each benchmark.
+     */
+    template<typename T_Result>
+    static std::vector<T_Result> gather(const T_Result& result) {
+      return {result};
+    }
+
     static T_Options& options() {
       static T_Options options;
       return options;
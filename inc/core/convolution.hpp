@@ -0,0 +1,142 @@
+#ifndef CONVOLUTION_HPP_
+#define CONVOLUTION_HPP_
+
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+namespace gearshifft {
+
+  /**
+   * Kernel of the convolution benchmarks (FFT_*_Convolution_*): separable
+   * taps c[j] = 2(j+1)/(w(w+1)), j < w, per dimension at the offsets
+   * j - w/2 (circular), w = min(Width, extent). The taps sum up to one, so
+   * the convolution keeps the magnitude of the test data. The compact support
+   * allows to validate the FFT convolution by the direct convolution.
+   */
+  template<typename RealType, size_t NDim>
+  class ConvolutionKernel {
+  public:
+    static constexpr size_t Width = 5;
+    /// direct convolution of more multiply-adds is only validated on a strided subset
+    static constexpr size_t DirectLimit = size_t(1) << 26;
+
+    explicit ConvolutionKernel(const std::array<size_t, NDim>& extents)
+      : extents_(extents) {
+      for(size_t d = 0; d < NDim; ++d) {
+        const size_t w = std::min(Width, extents_[d]);
+        taps_[d].resize(w);
+        for(size_t j = 0; j < w; ++j)
+          taps_[d][j] = 2.0*static_cast<double>(j+1)/static_cast<double>(w*(w+1));
+      }
+    }
+
+    size_t size() const {
+      return std::accumulate(extents_.begin(), extents_.end(),
+                             static_cast<size_t>(1), std::multiplies<size_t>());
+    }
+
+    /// multiply-adds of the direct convolution
+    size_t direct_cost() const {
+      size_t taps = 1;
+      for(size_t d = 0; d < NDim; ++d)
+        taps *= taps_[d].size();
+      return size()*taps;
+    }
+
+    /// writes the kernel to a zeroed row-major array of the extents (real or complex elements)
+    template<typename TVector>
+    void fill(TVector& vec) const {
+      using Value = typename TVector::value_type;
+      vec.assign(size(), Value(static_cast<RealType>(0)));
+      for_each_tap([&](const std::array<size_t, NDim>& j, double c) {
+          size_t i = 0;
+          for(size_t d = 0; d < NDim; ++d)
+            i = i*extents_[d] + position(d, j[d]);
+          vec[i] = Value(static_cast<RealType>(c));
+        });
+    }
+
+    /// element i of the circular convolution of a row-major array with the kernel
+    double convolve(const RealType* in, size_t i) const {
+      std::array<size_t, NDim> y;
+      for(size_t d = NDim; d-- > 0; ) {
+        y[d] = i % extents_[d];
+        i /= extents_[d];
+      }
+      double sum = 0.0;
+      for_each_tap([&](const std::array<size_t, NDim>& j, double c) {
+          size_t k = 0;
+          for(size_t d = 0; d < NDim; ++d)
+            k = k*extents_[d] + wrap(d, j[d], y[d]);
+          sum += c*static_cast<double>(in[k]);
+        });
+      return sum;
+    }
+
+  private:
+    std::array<size_t, NDim> extents_;
+    std::array<std::vector<double>, NDim> taps_;
+
+    /// offset of tap j in dimension d, circular
+    size_t position(size_t d, size_t j) const {
+      const size_t n = extents_[d];
+      return (n + j - taps_[d].size()/2) % n;
+    }
+
+    /// index y - offset of tap j in dimension d, circular
+    size_t wrap(size_t d, size_t j, size_t y) const {
+      const size_t n = extents_[d];
+      const size_t center = taps_[d].size()/2;
+      return (y + n + center - j) % n;
+    }
+
+    /// calls f(tap index per dimension, product of the taps) for all taps
+    template<typename TFunc>
+    void for_each_tap(TFunc f) const {
+      std::array<size_t, NDim> j = {{0}};
+      while(true) {
+        double c = 1.0;
+        for(size_t d = 0; d < NDim; ++d)
+          c *= taps_[d][j[d]];
+        f(j, c);
+        size_t d = NDim;
+        while(d-- > 0) {
+          if(++j[d] < taps_[d].size())
+            break;
+          j[d] = 0;
+        }
+        if(d >= NDim)
+          return;
+      }
+    }
+  };
+
+  /**
+   * Pointwise complex multiply of a spectrum by a kernel spectrum
+   * (interleaved real and imaginary parts, count complex values).
+   * Contiguous chunks are distributed to the threads, the loop body is
+   * branch-free, so it can be vectorized by the compiler.
+   */
+  template<typename RealType>
+  void multiply_spectrum(RealType* spectrum, const RealType* kernel, size_t count) {
+    parallel::for_chunks(count, [spectrum, kernel](size_t begin, size_t end) {
+        for(size_t k = begin; k < end; ++k) {
+          const RealType ar = spectrum[2*k];
+          const RealType ai = spectrum[2*k+1];
+          const RealType br = kernel[2*k];
+          const RealType bi = kernel[2*k+1];
+          spectrum[2*k] = ar*br - ai*bi;
+          spectrum[2*k+1] = ar*bi + ai*br;
+        }
+      });
+  }
+
+} // gearshifft
+
+#endif /* CONVOLUTION_HPP_ */
@@ -0,0 +1,141 @@
+#ifndef DENORMALS_HPP_
+#define DENORMALS_HPP_
+
+#include "types.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define GEARSHIFFT_HAS_MXCSR 1
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace gearshifft {
+
+  /**
+   * Control of subnormal (denormal) floating point handling.
+   *
+   * On x86 the MXCSR flags FTZ (flush-to-zero, bit 15) and DAZ
+   * (denormals-are-zero, bit 6) are set, on AArch64 the FZ bit of FPCR.
+   * The flags are per thread, see setFlushDenormalsAllThreads().
+   */
+  namespace denormals {
+
+    /// true if flushing denormals can be controlled on this architecture
+    inline bool supported() {
+#if defined(GEARSHIFFT_HAS_MXCSR) || defined(__aarch64__)
+      return true;
+#else
+      return false;
+#endif
+    }
+
+    /// sets or clears FTZ/DAZ of the calling thread
+    inline void setFlushDenormals(bool flush) {
+#if defined(GEARSHIFFT_HAS_MXCSR)
+      constexpr unsigned int FTZ = 0x8000;
+      constexpr unsigned int DAZ = 0x0040;
+      unsigned int csr = _mm_getcsr();
+      _mm_setcsr(flush ? (csr | FTZ | DAZ) : (csr & ~(FTZ | DAZ)));
+#elif defined(__aarch64__)
+      constexpr unsigned long FZ = 1ul << 24;
+      unsigned long fpcr;
+      __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+      fpcr = flush ? (fpcr | FZ) : (fpcr & ~FZ);
+      __asm__ __volatile__("msr fpcr, %0" : : "r"(fpcr));
+#else
+      static_cast<void>(flush);
+#endif
+    }
+
+    /// returns true if FTZ/DAZ is set for the calling thread
+    inline bool getFlushDenormals() {
+#if defined(GEARSHIFFT_HAS_MXCSR)
+      return (_mm_getcsr() & 0x8040) == 0x8040;
+#elif defined(__aarch64__)
+      unsigned long fpcr;
+      __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+      return (fpcr & (1ul << 24)) != 0;
+#else
+      return false;
+#endif
+    }
+
+    /**
+     * Sets or clears FTZ/DAZ of the calling thread and of the worker threads.
+     * OpenMP worker threads (e.g. of fftw3_omp) are pooled, so the flags are set
+     * inside a parallel region spanning all hardware threads.
+     * Threads created later (e.g. by parallel::for_each_chunk) inherit the
+     * floating point environment of the creating thread. Pooled pthreads of
+     * other libraries (e.g. fftw3_threads) cannot be reached and keep the flags
+     * they were created with.
+     */
+    inline void setFlushDenormalsAllThreads(bool flush) {
+      setFlushDenormals(flush);
+#ifdef _OPENMP
+      int nthreads = std::max(static_cast<int>(std::thread::hardware_concurrency()),
+                              omp_get_max_threads());
+#pragma omp parallel num_threads(nthreads)
+      setFlushDenormals(flush);
+#endif
+    }
+
+    template<typename T>
+    inline bool isSubnormal(const T& v) {
+      using std::fpclassify; // half_float::fpclassify is found by ADL
+      return fpclassify(v) == FP_SUBNORMAL;
+    }
+
+    template<typename T>
+    inline bool isSubnormal(const std::complex<T>& v) {
+      return isSubnormal(v.real()) || isSubnormal(v.imag());
+    }
+
+#if GEARSHIFFT_FLOAT16_SUPPORT == 1
+    inline bool isSubnormal(const gearshifft::complex<float16>& v) {
+      return isSubnormal(v.real()) || isSubnormal(v.imag());
+    }
+#endif
+
+    /// number of elements with subnormal (real or imaginary) values, counted by all threads
+    template<typename TVector>
+    size_t countSubnormals(const TVector& vec) {
+      const auto* data = vec.data();
+      return parallel::reduce(vec.size(), static_cast<size_t>(0),
+                              [data](size_t begin, size_t end) {
+                                size_t count = 0;
+                                for(size_t i = begin; i < end; ++i)
+                                  count += isSubnormal(data[i]) ? 1 : 0;
+                                return count;
+                              },
+                              [](size_t a, size_t b) { return a + b; });
+    }
+
+    /// --ftz-daz modes
+    enum class Mode { Off, On, Both };
+
+    inline Mode toMode(const std::string& str) {
+      if(str == "off")
+        return Mode::Off;
+      if(str == "on")
+        return Mode::On;
+      if(str == "both")
+        return Mode::Both;
+      throw std::runtime_error("Invalid ftz-daz mode (off, on or both).");
+    }
+
+  } // denormals
+} // gearshifft
+
+#endif /* DENORMALS_HPP_ */
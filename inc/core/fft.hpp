@@ -1,16 +1,21 @@
 #ifndef FFT_HPP_
 #define FFT_HPP_
 
+#include "convolution.hpp"
 #include "timer_cpu.hpp"
 #include "traits.hpp"
 #include "types.hpp"
 
 #include <array>
 #include <assert.h>
+#include <functional>
 #include <memory>
 #include <numeric>
 #include <ostream>
+#include <sstream>
+#include <string>
 #include <type_traits>
+#include <vector>
 
 #ifdef GEARSHIFFT_SCOREP_INSTRUMENTATION
 #include "scorep/SCOREP_User.h"
@@ -57,6 +62,181 @@ namespace gearshifft {
     static constexpr auto IsInplace = false;
   };
 
+  /// real-to-real transforms (DCT/DST/DHT) of real data, the kind is chosen by the client
+  struct FFT_Inplace_R2R {
+    static constexpr auto IsComplex = false;
+    static constexpr auto Title = "Inplace_R2R";
+    static constexpr auto IsInplace = true;
+  };
+
+  struct FFT_Outplace_R2R {
+    static constexpr auto IsComplex = false;
+    static constexpr auto Title = "Outplace_R2R";
+    static constexpr auto IsInplace = false;
+  };
+
+  /// complex transforms along a subset of the axes of a 2D/3D array, the axes are chosen by the client
+  struct FFT_Inplace_Axes_Complex {
+    static constexpr auto IsComplex = true;
+    static constexpr auto Title = "Inplace_Axes_Complex";
+    static constexpr auto IsInplace = true;
+  };
+
+  struct FFT_Outplace_Axes_Complex {
+    static constexpr auto IsComplex = true;
+    static constexpr auto Title = "Outplace_Axes_Complex";
+    static constexpr auto IsInplace = false;
+  };
+
+  /// complex transforms of split (planar) data, real and imaginary parts are separate arrays
+  struct FFT_Inplace_Split_Complex {
+    static constexpr auto IsComplex = true;
+    static constexpr auto Title = "Inplace_Split_Complex";
+    static constexpr auto IsInplace = true;
+  };
+
+  struct FFT_Outplace_Split_Complex {
+    static constexpr auto IsComplex = true;
+    static constexpr auto Title = "Outplace_Split_Complex";
+    static constexpr auto IsInplace = false;
+  };
+
+  /// complex transforms of any size by a convolution of power-of-two size (Bluestein's algorithm)
+  struct FFT_Inplace_Bluestein_Complex {
+    static constexpr auto IsComplex = true;
+    static constexpr auto Title = "Inplace_Bluestein_Complex";
+    static constexpr auto IsInplace = true;
+  };
+
+  struct FFT_Outplace_Bluestein_Complex {
+    static constexpr auto IsComplex = true;
+    static constexpr auto Title = "Outplace_Bluestein_Complex";
+    static constexpr auto IsInplace = false;
+  };
+
+  /// complex multi-dimensional transforms by 1D passes and transposes (row-column decomposition)
+  struct FFT_Inplace_RowColumn_Complex {
+    static constexpr auto IsComplex = true;
+    static constexpr auto Title = "Inplace_RowColumn_Complex";
+    static constexpr auto IsInplace = true;
+  };
+
+  struct FFT_Outplace_RowColumn_Complex {
+    static constexpr auto IsComplex = true;
+    static constexpr auto Title = "Outplace_RowColumn_Complex";
+    static constexpr auto IsInplace = false;
+  };
+
+  /// complex 1D transforms of a large size by FFTs of about sqrt(n), twiddles and transposes (four-step/six-step)
+  struct FFT_Inplace_FourStep_Complex {
+    static constexpr auto IsComplex = true;
+    static constexpr auto Title = "Inplace_FourStep_Complex";
+    static constexpr auto IsInplace = true;
+  };
+
+  struct FFT_Outplace_FourStep_Complex {
+    static constexpr auto IsComplex = true;
+    static constexpr auto Title = "Outplace_FourStep_Complex";
+    static constexpr auto IsInplace = false;
+  };
+
+  /// real 1D transforms by complex FFTs of packed real signals (half-length or two-for-one)
+  struct FFT_Inplace_Packed_Real {
+    static constexpr auto IsComplex = false;
+    static constexpr auto Title = "Inplace_Packed_Real";
+    static constexpr auto IsInplace = true;
+  };
+
+  struct FFT_Outplace_Packed_Real {
+    static constexpr auto IsComplex = false;
+    static constexpr auto Title = "Outplace_Packed_Real";
+    static constexpr auto IsInplace = false;
+  };
+
+  /// forward transform, pointwise multiply by a cached kernel spectrum and inverse transform
+  struct FFT_Inplace_Convolution_Real {
+    static constexpr auto IsComplex = false;
+    static constexpr auto Title = "Inplace_Convolution_Real";
+    static constexpr auto IsInplace = true;
+    static constexpr auto IsConvolution = true;
+  };
+
+  struct FFT_Outplace_Convolution_Real {
+    static constexpr auto IsComplex = false;
+    static constexpr auto Title = "Outplace_Convolution_Real";
+    static constexpr auto IsInplace = false;
+    static constexpr auto IsConvolution = true;
+  };
+
+  struct FFT_Inplace_Convolution_Complex {
+    static constexpr auto IsComplex = true;
+    static constexpr auto Title = "Inplace_Convolution_Complex";
+    static constexpr auto IsInplace = true;
+    static constexpr auto IsConvolution = true;
+  };
+
+  struct FFT_Outplace_Convolution_Complex {
+    static constexpr auto IsComplex = true;
+    static constexpr auto Title = "Outplace_Convolution_Complex";
+    static constexpr auto IsInplace = false;
+    static constexpr auto IsConvolution = true;
+  };
+
+  template<typename T_FFT>
+  struct is_r2r : std::false_type {};
+  template<>
+  struct is_r2r<FFT_Inplace_R2R> : std::true_type {};
+  template<>
+  struct is_r2r<FFT_Outplace_R2R> : std::true_type {};
+
+  template<typename T_FFT>
+  struct is_axes : std::false_type {};
+  template<>
+  struct is_axes<FFT_Inplace_Axes_Complex> : std::true_type {};
+  template<>
+  struct is_axes<FFT_Outplace_Axes_Complex> : std::true_type {};
+
+  template<typename T_FFT>
+  struct is_split : std::false_type {};
+  template<>
+  struct is_split<FFT_Inplace_Split_Complex> : std::true_type {};
+  template<>
+  struct is_split<FFT_Outplace_Split_Complex> : std::true_type {};
+
+  /**
+   * Predicted memory footprint of an FFT client, see FFT::footprint().
+   */
+  struct FFTFootprint {
+    /// buffers of the client (get_allocation_size())
+    size_t allocation = 0;
+    /// size of one data transfer (get_transfer_size())
+    size_t transfer = 0;
+    /// client buffers live in host memory (CPU back-ends)
+    bool host_resident = false;
+  };
+
+  /**
+   * Footprint of dense R2C/C2R or C2C buffers, the complex data of real
+   * transforms has n/2+1 elements along the last extent (in-place: real data
+   * is padded to it).
+   * \param real_size Size in bytes of a real value.
+   */
+  template<bool IsComplex, bool IsInplace, size_t NDim>
+  inline FFTFootprint dense_footprint(const std::array<size_t,NDim>& extents, size_t real_size) {
+    size_t n = 1;
+    size_t n_complex = 1;
+    for(size_t i = 0; i < NDim; ++i) {
+      n *= extents[i];
+      n_complex *= (IsComplex || i+1 < NDim) ? extents[i] : extents[i]/2 + 1;
+    }
+    const size_t value_size = IsComplex ? 2*real_size : real_size;
+    const size_t data_size = (IsInplace && !IsComplex ? 2*n_complex : n) * value_size;
+    FFTFootprint fp;
+    fp.allocation = data_size + (IsInplace ? 0 : n_complex * 2*real_size);
+    fp.transfer = n * value_size;
+    return fp;
+  }
+
   using FFT_Plan_Reusable = std::true_type;
   using FFT_Plan_Not_Reusable = std::false_type;
 
@@ -85,11 +265,16 @@ namespace gearshifft {
 
       using PrecisionT = typename Precision<typename T_Vector::value_type,
                                             T_FFT::IsComplex >::type;
+      using ClientT = T_Client<T_FFT, PrecisionT, NDim, T_ClientArgs...>;
+      using IsConvolutionT = std::integral_constant<bool, is_convolution<T_FFT>::value>;
       assert(vec.size());
 
+      // spectrum of the convolution kernel, computed by the client on first use
+      const auto kernel = kernelSpectrum<ClientT, PrecisionT>(vec, extents, IsConvolutionT());
+
       // prepare plan object
       // templates in: FFT type: in[,out][complex], PlanImpl, Precision, NDim
-      auto fft = T_Client<T_FFT, PrecisionT, NDim, T_ClientArgs...> (extents);
+      auto fft = ClientT(extents);
       result.setValue(RecordType::DevBufferSize, fft.get_allocation_size());
       result.setValue(RecordType::DevPlanSize, fft.get_plan_size());
       result.setValue(RecordType::DevTransferSize, fft.get_transfer_size());
@@ -137,6 +322,8 @@ namespace gearshifft {
         result.setValue(RecordType::FFT, tdev.stopTimer());
       }
 
+      multiply<PrecisionT>(result, fft, kernel, IsConvolutionT());
+
       if(T_ReusePlan::value) {
         FLUSH();
         SCOREP_USER_REGION("plan_backward_reuse", SCOREP_USER_REGION_TYPE_DYNAMIC)
@@ -167,9 +354,301 @@ namespace gearshifft {
 
       result.setValue(RecordType::Total, tcpu_total.stopTimer());
 
+      recordPlanCache(result, fft, std::integral_constant<bool, has_plan_cache<decltype(fft)>::value>());
+      recordChirpCache(result, fft, std::integral_constant<bool, has_chirp_cache<decltype(fft)>::value>());
+      recordCommunication(result, fft, std::integral_constant<bool, has_communication<decltype(fft)>::value>());
+      recordStageTimes(result, fft, std::integral_constant<bool, has_stage_times<decltype(fft)>::value>());
+      recordConvolution(result, IsConvolutionT());
+    }
+
+    /**
+     * Predicts memory requirements of the client by its static size query
+     * (ClientT::footprint()), no client is created, so neither planners nor
+     * device contexts are initialized. Used for preflight checks before host
+     * data is created.
+     */
+    template<typename T_Precision, size_t NDim>
+    static FFTFootprint footprint(const std::array<size_t,NDim>& extents) {
+      using ClientT = T_Client<T_FFT, T_Precision, NDim, T_ClientArgs...>;
+      FFTFootprint fp = ClientT::footprint(extents);
+      fp.host_resident = uses_host_memory<ClientT>::value;
+      return fp;
+    }
+
+    /**
+     * Benchmarks of this FFT kind are only registered if the client
+     * supports them (e.g. R2R transforms have been selected).
+     */
+    template<typename T_Precision, size_t NDim>
+    static bool enabled() {
+      using ClientT = T_Client<T_FFT, T_Precision, NDim, T_ClientArgs...>;
+      return client_enabled<ClientT>(std::integral_constant<bool, has_enabled<ClientT>::value>());
+    }
+
+    /**
+     * Factor of the unnormalized round trip iFFT(FFT(x)) = factor*x,
+     * number of elements unless given by the client (e.g. 2N for DCT-II/III,
+     * product of the transformed extents for axis-wise transforms).
+     */
+    template<typename T_Precision, size_t NDim>
+    static double normalization(const std::array<size_t,NDim>& extents) {
+      using ClientT = T_Client<T_FFT, T_Precision, NDim, T_ClientArgs...>;
+      return client_normalization<ClientT>(extents, std::integral_constant<bool, has_normalization<ClientT>::value>());
+    }
+
+    /**
+     * Plan variants of the client, each benchmark is run once per variant
+     * (e.g. FFTW rigors). Empty if the client has no variants.
+     */
+    template<typename T_Precision, size_t NDim>
+    static std::vector<std::string> variants() {
+      using ClientT = T_Client<T_FFT, T_Precision, NDim, T_ClientArgs...>;
+      return client_variants<ClientT>(std::integral_constant<bool, has_variants<ClientT>::value>());
+    }
+
+    /// selects a variant for the next client instances, empty string selects default
+    template<typename T_Precision, size_t NDim>
+    static void select_variant(const std::string& variant) {
+      using ClientT = T_Client<T_FFT, T_Precision, NDim, T_ClientArgs...>;
+      selected_variant() = variant;
+      client_select_variant<ClientT>(variant, std::integral_constant<bool, has_variants<ClientT>::value>());
+    }
+
+    /**
+     * Variants of the same group compute the same transform and are compared
+     * (pruning, amortization), e.g. configurations of one R2R kind.
+     */
+    template<typename T_Precision, size_t NDim>
+    static std::string variant_group(const std::string& variant) {
+      using ClientT = T_Client<T_FFT, T_Precision, NDim, T_ClientArgs...>;
+      return client_variant_group<ClientT>(variant, std::integral_constant<bool, has_variant_group<ClientT>::value>());
+    }
+
+    /**
+     * Swept layout of a variant (e.g. "pad=3" of a leading-dimension sweep),
+     * empty if the variant is not part of a layout sweep.
+     */
+    template<typename T_Precision, size_t NDim>
+    static std::string variant_sweep(const std::string& variant) {
+      using ClientT = T_Client<T_FFT, T_Precision, NDim, T_ClientArgs...>;
+      return client_variant_sweep<ClientT>(variant, std::integral_constant<bool, has_variant_sweep<ClientT>::value>());
+    }
+
+    /**
+     * Reason why the selected variant cannot transform the extents (e.g. odd
+     * size of a half-length real transform), empty if it can.
+     */
+    template<typename T_Precision, size_t NDim>
+    static std::string unsupported(const std::array<size_t,NDim>& extents) {
+      using ClientT = T_Client<T_FFT, T_Precision, NDim, T_ClientArgs...>;
+      return client_unsupported<ClientT>(extents, std::integral_constant<bool, has_unsupported<ClientT>::value>());
+    }
+
+  private:
+
+    /// variant of the next client instances, the kernel spectrum is cached per variant
+    static std::string& selected_variant() {
+      static std::string variant;
+      return variant;
+    }
+
+    template<typename ClientT>
+    static bool client_enabled(std::true_type) {
+      return ClientT::enabled();
+    }
+
+    template<typename ClientT>
+    static bool client_enabled(std::false_type) {
+      return true;
+    }
+
+    template<typename ClientT, size_t NDim>
+    static double client_normalization(const std::array<size_t,NDim>& extents, std::true_type) {
+      return ClientT::normalization(extents);
+    }
+
+    template<typename ClientT, size_t NDim>
+    static double client_normalization(const std::array<size_t,NDim>& extents, std::false_type) {
+      return std::accumulate(extents.begin(), extents.end(), 1.0, std::multiplies<double>());
+    }
+
+    template<typename ClientT>
+    static std::vector<std::string> client_variants(std::true_type) {
+      return ClientT::variants();
+    }
+
+    template<typename ClientT>
+    static std::vector<std::string> client_variants(std::false_type) {
+      return {};
+    }
+
+    template<typename ClientT>
+    static void client_select_variant(const std::string& variant, std::true_type) {
+      ClientT::select_variant(variant);
+    }
+
+    template<typename ClientT>
+    static void client_select_variant(const std::string&, std::false_type) {
+    }
+
+    template<typename ClientT>
+    static std::string client_variant_group(const std::string& variant, std::true_type) {
+      return ClientT::variant_group(variant);
+    }
+
+    template<typename ClientT>
+    static std::string client_variant_group(const std::string&, std::false_type) {
+      return "";
+    }
 
+    template<typename ClientT>
+    static std::string client_variant_sweep(const std::string& variant, std::true_type) {
+      return ClientT::variant_sweep(variant);
     }
 
+    template<typename ClientT>
+    static std::string client_variant_sweep(const std::string&, std::false_type) {
+      return "";
+    }
+
+    template<typename ClientT, size_t NDim>
+    static std::string client_unsupported(const std::array<size_t,NDim>& extents, std::true_type) {
+      return ClientT::unsupported(extents);
+    }
+
+    template<typename ClientT, size_t NDim>
+    static std::string client_unsupported(const std::array<size_t,NDim>&, std::false_type) {
+      return "";
+    }
+
+    /// number of plans created from a plan cache of the client (e.g. FFTW wisdom)
+    template<typename T_Result, typename T_ClientObj>
+    static void recordPlanCache(T_Result& result, T_ClientObj& fft, std::true_type) {
+      result.setValue(RecordType::PlanCacheHits, fft.get_plan_cache_hits());
+      result.setValue(RecordType::PlanCacheMisses, fft.get_plan_cache_misses());
+    }
+
+    template<typename T_Result, typename T_ClientObj>
+    static void recordPlanCache(T_Result&, T_ClientObj&, std::false_type) {
+    }
+
+    /// number of chirps taken from a chirp cache of the client (e.g. Bluestein)
+    template<typename T_Result, typename T_ClientObj>
+    static void recordChirpCache(T_Result& result, T_ClientObj& fft, std::true_type) {
+      result.setValue(RecordType::ChirpCacheHits, fft.get_chirp_cache_hits());
+      result.setValue(RecordType::ChirpCacheMisses, fft.get_chirp_cache_misses());
+    }
+
+    template<typename T_Result, typename T_ClientObj>
+    static void recordChirpCache(T_Result&, T_ClientObj&, std::false_type) {
+    }
+
+    /**
+     * Communication time of forward and inverse transform (e.g. all-to-all of
+     * distributed transforms) and its share of the transform time.
+     * Measured by the client after the benchmarked methods.
+     */
+    template<typename T_Result, typename T_ClientObj>
+    static void recordCommunication(T_Result& result, T_ClientObj& fft, std::true_type) {
+      const double time = fft.get_communication_time();
+      const double transform = result.getValue(RecordType::FFT) + result.getValue(RecordType::FFTInv);
+      result.setValue(RecordType::Communication, time);
+      result.setValue(RecordType::CommunicationShare, transform > 0.0 ? time/transform : 0.0);
+    }
+
+    template<typename T_Result, typename T_ClientObj>
+    static void recordCommunication(T_Result&, T_ClientObj&, std::false_type) {
+    }
+
+    /**
+     * Time of the stages of forward and inverse transform (e.g. 1D passes and
+     * transposes of a row-column decomposition), measured by the client.
+     */
+    template<typename T_Result, typename T_ClientObj>
+    static void recordStageTimes(T_Result& result, T_ClientObj& fft, std::true_type) {
+      for(const auto& stage : fft.get_stage_times())
+        result.setValue(stage.first, stage.second);
+    }
+
+    template<typename T_Result, typename T_ClientObj>
+    static void recordStageTimes(T_Result&, T_ClientObj&, std::false_type) {
+    }
+
+    /**
+     * Spectrum of the ConvolutionKernel in the layout of the client spectrum
+     * (interleaved real and imaginary parts), computed by a forward transform
+     * of a separate client instance. Cached for the runs of a benchmark variant.
+     */
+    template<typename ClientT, typename T_Precision, typename T_Vector, size_t NDim>
+    static const std::vector<T_Precision>* kernelSpectrum(const T_Vector&,
+                                                          const std::array<size_t,NDim>& extents,
+                                                          std::true_type) {
+      static_assert(has_spectrum<ClientT>::value, "Convolution benchmarks need the spectrum of the FFT client (get_spectrum()).");
+      struct Cache {
+        std::string key;
+        std::vector<T_Precision> spectrum;
+      };
+      static Cache cache;
+      std::stringstream key;
+      key << selected_variant();
+      for(auto e : extents)
+        key << "/" << e;
+      if(cache.key != key.str()) {
+        T_Vector kernel;
+        ConvolutionKernel<T_Precision, NDim>(extents).fill(kernel);
+        auto fft = ClientT(extents);
+        fft.allocate();
+        fft.init_forward();
+        fft.upload(kernel.data());
+        fft.execute_forward();
+        const T_Precision* spectrum = reinterpret_cast<const T_Precision*>(fft.get_spectrum());
+        cache.spectrum.assign(spectrum, spectrum + 2*fft.get_spectrum_size());
+        fft.destroy();
+        cache.key = key.str();
+      }
+      return &cache.spectrum;
+    }
+
+    template<typename ClientT, typename T_Precision, typename T_Vector, size_t NDim>
+    static std::nullptr_t kernelSpectrum(const T_Vector&, const std::array<size_t,NDim>&, std::false_type) {
+      return nullptr;
+    }
+
+    /// pointwise multiply of the client spectrum by the kernel spectrum (host memory)
+    template<typename T_Precision, typename T_Result, typename T_ClientObj>
+    static void multiply(T_Result& result,
+                         T_ClientObj& fft,
+                         const std::vector<T_Precision>* kernel,
+                         std::true_type) {
+      SCOREP_USER_REGION("multiply", SCOREP_USER_REGION_TYPE_DYNAMIC)
+      assert(kernel->size() == 2*fft.get_spectrum_size());
+      TimerCPU timer;
+      timer.startTimer();
+      multiply_spectrum(reinterpret_cast<T_Precision*>(fft.get_spectrum()),
+                        kernel->data(),
+                        fft.get_spectrum_size());
+      result.setValue(RecordType::Multiply, timer.stopTimer());
+    }
+
+    template<typename T_Precision, typename T_Result, typename T_ClientObj>
+    static void multiply(T_Result&, T_ClientObj&, std::nullptr_t, std::false_type) {
+    }
+
+    /// end-to-end time of a convolution and share of the pointwise multiply
+    template<typename T_Result>
+    static void recordConvolution(T_Result& result, std::true_type) {
+      const double multiply = result.getValue(RecordType::Multiply);
+      const double time = result.getValue(RecordType::FFT) + multiply + result.getValue(RecordType::FFTInv);
+      result.setValue(RecordType::Convolution, time);
+      result.setValue(RecordType::MultiplyShare, time > 0.0 ? multiply/time : 0.0);
+    }
+
+    template<typename T_Result>
+    static void recordConvolution(T_Result&, std::false_type) {
+    }
+
+  public:
+
     static constexpr std::size_t flushBufferSize = 4 * GEARSHIFFT_FLUSH_LLC_SIZE_MEBIBYTES * (1 << 20);
     static constexpr std::size_t flushStride     =     GEARSHIFFT_FLUSH_CL_SIZE_BYTES;
     static std::unique_ptr<volatile char[]> flushBuffer;  // no std::byte in C++14
@@ -22,6 +22,14 @@
 #warning "Unable to define getMemorySize( ) for an unknown OS."
 #endif
 
+#if defined(__linux__)
+#include <fstream>
+#include <sstream>
+#include <string>
+#endif
+
+#include <algorithm>
+
 /**
  * Returns the size of physical memory (RAM) in bytes.
  */
@@ -97,4 +105,118 @@ inline size_t getMemorySize( )
   #endif
 }
 
+#if defined(__linux__)
+/**
+ * Reads the first value of a cgroup or procfs file.
+ * \return false if the file does not exist or holds no number (e.g. "max").
+ */
+inline bool readMemoryValue( const std::string& file, size_t& value )
+{
+  std::ifstream ifs(file);
+  std::string token;
+  if( !(ifs >> token) )
+    return false;
+  if( token.empty() || token.find_first_not_of("0123456789") != std::string::npos )
+    return false;
+  value = static_cast<size_t>(std::stoull(token));
+  return true;
+}
+
+/**
+ * Returns the cgroup path of the memory controller of this process
+ * (cgroup v1 "N:memory:/path" or cgroup v2 "0::/path").
+ */
+inline std::string getCgroupMemoryPath( bool& v2 )
+{
+  std::ifstream ifs("/proc/self/cgroup");
+  std::string line;
+  std::string path_v2;
+  bool has_v2 = false;
+  while( std::getline(ifs, line) ) {
+    std::size_t c1 = line.find(':');
+    std::size_t c2 = line.find(':', c1+1);
+    if( c1 == std::string::npos || c2 == std::string::npos )
+      continue;
+    std::string controllers = line.substr(c1+1, c2-c1-1);
+    std::string path = line.substr(c2+1);
+    if( controllers.empty() ) {
+      has_v2 = true;
+      path_v2 = path;
+    }
+    std::stringstream ss(controllers);
+    std::string controller;
+    while( std::getline(ss, controller, ',') ) {
+      if( controller == "memory" ) {
+        v2 = false;
+        return path;
+      }
+    }
+  }
+  v2 = has_v2;
+  return path_v2;
+}
+#endif
+
+/**
+ * Returns the memory limit of the cgroup (v1 or v2) this process runs in,
+ * e.g. the memory limit of a container or a batch job.
+ * \param usage Current memory usage of the cgroup in bytes (0 if unknown).
+ * \return Limit in bytes, or size_t(-1) if there is no limit.
+ */
+inline size_t getCgroupMemoryLimit( size_t& usage )
+{
+  size_t limit = static_cast<size_t>(-1);
+  usage = 0;
+#if defined(__linux__)
+  bool v2 = false;
+  std::string path = getCgroupMemoryPath(v2);
+  std::string root = v2 ? "/sys/fs/cgroup" : "/sys/fs/cgroup/memory";
+  std::string limit_file = v2 ? "/memory.max" : "/memory.limit_in_bytes";
+  std::string usage_file = v2 ? "/memory.current" : "/memory.usage_in_bytes";
+  if( path == "/" )
+    path.clear();
+  // inside a cgroup namespace the own cgroup is mounted as root
+  for( const std::string& dir : { root + path, root } ) {
+    if( readMemoryValue(dir + limit_file, limit) ) {
+      readMemoryValue(dir + usage_file, usage);
+      break;
+    }
+    if( std::ifstream(dir + limit_file).good() ) // "max" = unlimited
+      break;
+  }
+  // cgroup v1 reports "unlimited" as a huge page-aligned number
+  if( limit >= getMemorySize() )
+    limit = static_cast<size_t>(-1);
+#endif
+  return limit;
+}
+
+/**
+ * Returns the memory in bytes which can be allocated without swapping or
+ * hitting the cgroup limit.
+ * On Linux this is the minimum of MemAvailable from /proc/meminfo and
+ * the headroom of the cgroup limit. Otherwise physical memory is returned.
+ */
+inline size_t getAvailableMemorySize( )
+{
+  size_t available = getMemorySize();
+#if defined(__linux__)
+  std::ifstream ifs("/proc/meminfo");
+  std::string key;
+  size_t value = 0;
+  std::string unit;
+  while( ifs >> key >> value >> unit ) {
+    if( key == "MemAvailable:" ) {
+      available = std::min(available, value * static_cast<size_t>(1024));
+      break;
+    }
+  }
+  size_t usage = 0;
+  size_t limit = getCgroupMemoryLimit(usage);
+  if( limit != static_cast<size_t>(-1) )
+    available = std::min(available, limit > usage ? limit - usage : 0);
+#endif
+  return available;
+}
+
 #endif /* GET_MEMORY_SIZE_H */
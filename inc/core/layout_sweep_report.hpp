@@ -0,0 +1,131 @@
+#ifndef LAYOUT_SWEEP_REPORT_HPP_
+#define LAYOUT_SWEEP_REPORT_HPP_
+
+#include <algorithm>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace gearshifft {
+
+  /**
+   * Transform times of a benchmark over a swept buffer layout (e.g. the
+   * leading-dimension padding of FFTW, "pad=0" to "pad=k"), the logical
+   * extent is the same for all layouts. The fastest layout is highlighted,
+   * the times are compared to the first layout of the sweep.
+   */
+  class LayoutSweepReport {
+  public:
+
+    /**
+     * Adds a layout of a benchmark.
+     * \param name Precision, extents and FFT kind of the benchmark.
+     * \param config Remaining variant label without the swept layout.
+     * \param layout Swept layout (e.g. "pad=3").
+     * \param time Forward and inverse transform [ms], mean of warm runs.
+     * \param bytes Allocated buffers of the FFT client.
+     * \param pruned Only the first warm run has been measured.
+     */
+    void add(const std::string& name,
+             const std::string& config,
+             const std::string& layout,
+             double time,
+             size_t bytes,
+             bool pruned) {
+      std::lock_guard<std::mutex> g(mutex_);
+      auto it = std::find_if(benchmarks_.begin(), benchmarks_.end(),
+                             [&](const Benchmark& b) { return b.name == name && b.config == config; });
+      if(it == benchmarks_.end()) {
+        benchmarks_.push_back(Benchmark{name, config, {}});
+        it = benchmarks_.end()-1;
+      }
+      it->layouts.push_back(Layout{layout, time, bytes, pruned});
+    }
+
+    bool empty() const {
+      std::lock_guard<std::mutex> g(mutex_);
+      return benchmarks_.empty();
+    }
+
+    /// removes the token of the swept layout from a variant label ("pad=3;rigor=measure" -> "rigor=measure")
+    static std::string remove_token(const std::string& label, const std::string& token) {
+      std::stringstream ss(label);
+      std::string t;
+      std::string result;
+      while(std::getline(ss, t, ';')) {
+        if(t != token)
+          result += (result.empty() ? "" : ";") + t;
+      }
+      return result;
+    }
+
+    void report(std::ostream& os, const std::string& apptitle) const {
+      std::lock_guard<std::mutex> g(mutex_);
+      size_t width = 9;
+      size_t lwidth = 6;
+      for(const auto& b : benchmarks_) {
+        width = std::max(width, b.name.size() + (b.config.empty() ? 0 : b.config.size()+1));
+        for(const auto& l : b.layouts)
+          lwidth = std::max(lwidth, l.name.size());
+      }
+
+      std::stringstream ss;
+      ss << "; Layout sweep of " << apptitle
+         << " (time = fwd+inv transform, mean of warm runs, * = fastest layout)\n"
+         << std::left << std::setw(static_cast<int>(width)) << "Benchmark"
+         << "  " << std::setw(static_cast<int>(lwidth)) << "Layout" << std::right
+         << std::setw(14) << "Time [ms]"
+         << std::setw(12) << "Speedup"
+         << std::setw(18) << "Buffers [bytes]"
+         << "\n";
+
+      for(const auto& b : benchmarks_) {
+        const std::string name = b.config.empty() ? b.name : b.name + "/" + b.config;
+        const Layout& first = b.layouts.front();
+        size_t best = 0;
+        for(size_t k = 1; k < b.layouts.size(); ++k) {
+          if(b.layouts[k].time < b.layouts[best].time)
+            best = k;
+        }
+        for(size_t k = 0; k < b.layouts.size(); ++k) {
+          const Layout& l = b.layouts[k];
+          std::stringstream speedup;
+          speedup << std::fixed << std::setprecision(2) << first.time/l.time << "x";
+          ss << std::left << std::setw(static_cast<int>(width)) << (k == 0 ? name : "")
+             << (k == best ? "* " : "  ")
+             << std::setw(static_cast<int>(lwidth)) << l.name << std::right
+             << std::setw(14) << std::setprecision(6) << l.time
+             << std::setw(12) << speedup.str()
+             << std::setw(18) << l.bytes
+             << (l.pruned ? "  (pruned)" : "")
+             << "\n";
+        }
+      }
+      ss << "; Speedup = time of the first layout / time of the layout\n";
+      os << ss.str() << std::flush;
+    }
+
+  private:
+    struct Layout {
+      std::string name;
+      double time;
+      size_t bytes;
+      bool pruned;
+    };
+
+    struct Benchmark {
+      std::string name;
+      std::string config;
+      std::vector<Layout> layouts;
+    };
+
+    mutable std::mutex mutex_;
+    std::vector<Benchmark> benchmarks_;
+  };
+
+} // gearshifft
+
+#endif /* LAYOUT_SWEEP_REPORT_HPP_ */
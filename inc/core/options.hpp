@@ -2,11 +2,14 @@
 #define OPTIONS_HPP_
 
 #include "types.hpp"
+#include "validation.hpp"
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wold-style-cast"
 #include <boost/program_options.hpp>
 #include <boost/core/noncopyable.hpp>
 #pragma GCC diagnostic pop
+#include <array>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -62,6 +65,90 @@ namespace gearshifft {
       return ndevices_;
     }
 
+    /**
+     * Memory budget in bytes for host buffers of a benchmark.
+     * If no budget was given (auto), 95% of the memory available at startup is used
+     * (respects MemAvailable and cgroup limits, see get_memory_size.hpp).
+     */
+    size_t getMemoryBudget() const;
+
+    /**
+     * Memory limit in bytes for test data kept from previous extents.
+     * The test data of the current benchmark is always kept.
+     */
+    size_t getDataCacheLimit() const;
+
+    /// walk the benchmarks and print predicted memory and runtime only
+    bool getDryRun() const {
+      return dryRun_;
+    }
+
+    /// benchmarks with a larger predicted memory footprint are skipped (0 = no limit)
+    size_t getMaxBytes() const {
+      return maxBytes_;
+    }
+
+    /// benchmarks with a larger predicted runtime in seconds are skipped (<=0 = no limit)
+    double getMaxPredictedTime() const {
+      return maxPredictedTime_;
+    }
+
+    /// flush denormals: off, on or both (each benchmark runs with and without)
+    const std::string& getFtzDaz() const {
+      return ftzDaz_;
+    }
+
+    /// which runs and elements are validated
+    const ValidationPolicy& getValidationPolicy() const {
+      return validation_;
+    }
+
+    /// csv file for the measured configurations of each extent, empty if not written
+    const std::string& getTuningTable() const {
+      return tuningTable_;
+    }
+
+    /**
+     * Variants of a benchmark are stopped after the first warm run, if their
+     * transform time exceeds factor * time of the best variant (<=0 = no pruning).
+     */
+    double getPruneFactor() const {
+      return pruneFactor_;
+    }
+
+    /**
+     * Padding ratio of --advise-padding, each dimension is benchmarked with the
+     * sizes 2^a*3^b*5^c*7^d up to (1+ratio) times its size (0 = no advice).
+     */
+    double getAdvisePadding() const {
+      return advisePadding_;
+    }
+
+    /// convolution benchmarks (forward transform, pointwise multiply, inverse transform) are enabled
+    bool getConvolution() const {
+      return convolution_;
+    }
+
+    /// extents given by the user, for which padding is advised (without padded candidates)
+    const std::vector<std::vector<size_t> >& getPaddingOrigins() const {
+      return paddingOrigins_;
+    }
+
+    /// previous result file used for runtime prediction
+    const std::string& getPredictFrom() const {
+      return predictFrom_;
+    }
+
+    /**
+     * Planning time budget in seconds of an extent, given by <extent>:<seconds>
+     * (e.g. -e 1024x1024:0.5). Returns <=0 if no budget was given.
+     */
+    template<size_t NDim>
+    double getPlanBudget(const std::array<size_t, NDim>& extents) const {
+      auto it = planBudgets_.find(std::vector<size_t>(extents.begin(), extents.end()));
+      return it == planBudgets_.end() ? -1.0 : it->second;
+    }
+
     auto add_options() {
       return desc_.add_options();
     }
@@ -70,6 +157,9 @@ namespace gearshifft {
 
     void parseExtent( const std::string& extent );
 
+    /// adds the padded candidates of every extent (--advise-padding)
+    void addPaddedExtents();
+
     /// processes command line arguments and apply the values to the variables
     int parse(std::vector<char*>&, std::vector<char*>&);
 
@@ -99,8 +189,23 @@ namespace gearshifft {
     std::string outputFile_;
     std::string device_;
     std::string tag_;
+    std::string predictFrom_;
+    std::string ftzDaz_;
+    std::string tuningTable_;
+
+    ValidationPolicy validation_;
 
     size_t ndevices_ = 0;
+    /// auto budget is derived from the available memory when options are parsed
+    long long memoryBudget_ = -1;
+    size_t maxBytes_ = 0;
+    /// <0 = derive limit from memory budget
+    long long dataCache_ = -1;
+    double maxPredictedTime_ = 0.0;
+    double pruneFactor_ = 0.0;
+    double advisePadding_ = 0.0;
+    bool dryRun_ = false;
+    bool convolution_ = false;
     bool help_ = false;
     bool verbose_ = false;
     bool version_ = false;
@@ -111,6 +216,9 @@ namespace gearshifft {
     Extents1DVec vector1D_;
     Extents2DVec vector2D_;
     Extents3DVec vector3D_;
+    std::vector<std::vector<size_t> > paddingOrigins_;
+    /// planning time budgets in seconds per extent
+    std::map<std::vector<size_t>, double> planBudgets_;
 
     boost::program_options::options_description desc_ =
       boost::program_options::options_description("gearshifft options and flags");
@@ -0,0 +1,186 @@
+#ifndef PADDING_ADVISOR_HPP_
+#define PADDING_ADVISOR_HPP_
+
+#include "result_benchmark.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace gearshifft {
+
+  /**
+   * Padding advice (--advise-padding): a slow extent (prime factor > 7) can
+   * be zero-padded to a nearby size 2^a*3^b*5^c*7^d. Each dimension of an
+   * extent is benchmarked with the candidate sizes within the padding ratio,
+   * the other dimensions are kept. The fastest padded size per dimension is
+   * reported with the speedup and the extra memory against the original extent.
+   */
+  class PaddingAdvisor {
+  public:
+
+    /// sizes 2^a*3^b*5^c*7^d in (n, n*(1+ratio)], ascending
+    static std::vector<size_t> candidates(size_t n, double ratio) {
+      std::vector<size_t> result;
+      const size_t hi = static_cast<size_t>(std::floor(static_cast<double>(n)*(1.0+ratio)));
+      for(size_t p2 = 1; p2 <= hi; p2 *= 2)
+        for(size_t p3 = p2; p3 <= hi; p3 *= 3)
+          for(size_t p5 = p3; p5 <= hi; p5 *= 5)
+            for(size_t p7 = p5; p7 <= hi; p7 *= 7)
+              if(p7 > n)
+                result.push_back(p7);
+      std::sort(result.begin(), result.end());
+      return result;
+    }
+
+    /// only dimensions with a prime factor > 7 are padded, FFT libraries are fast for the others
+    static bool searched(size_t n) {
+      return n > 1 && isNotOnlyDivBy_2_3_5_7(n);
+    }
+
+    /**
+     * Padded extents of an extent, one dimension padded at a time.
+     * \return pairs of padded dimension and padded extent
+     */
+    static std::vector<std::pair<size_t, std::vector<size_t> > >
+    padded(const std::vector<size_t>& extents, double ratio) {
+      std::vector<std::pair<size_t, std::vector<size_t> > > result;
+      for(size_t d = 0; d < extents.size(); ++d) {
+        if(!searched(extents[d]))
+          continue;
+        for(size_t c : candidates(extents[d], ratio)) {
+          auto e = extents;
+          e[d] = c;
+          result.emplace_back(d, e);
+        }
+      }
+      return result;
+    }
+
+    /**
+     * Adds a measured benchmark.
+     * \param benchmark Precision, FFT kind and variant (e.g. "float/Outplace_Complex").
+     * \param time Forward and inverse transform [ms], mean of warm runs.
+     * \param bytes Allocated buffers of the FFT client.
+     */
+    void add(const std::string& benchmark,
+             const std::vector<size_t>& extents,
+             double time,
+             size_t bytes) {
+      std::lock_guard<std::mutex> g(mutex_);
+      auto& entries = benchmarks_[benchmark];
+      if(entries.empty())
+        order_.push_back(benchmark);
+      entries[extents] = Entry{time, bytes};
+    }
+
+    bool empty() const {
+      std::lock_guard<std::mutex> g(mutex_);
+      return benchmarks_.empty();
+    }
+
+    /**
+     * Prints the fastest padded size per dimension of every original extent.
+     * \param extents Original extents (without the padded candidates).
+     */
+    void report(std::ostream& os,
+                const std::string& apptitle,
+                const std::vector<std::vector<size_t> >& extents,
+                double ratio) const {
+      std::lock_guard<std::mutex> g(mutex_);
+      size_t width = 9;
+      for(const auto& b : order_)
+        width = std::max(width, b.size());
+
+      std::stringstream ss;
+      ss << "; Padding advice of " << apptitle
+         << " (candidates 2^a*3^b*5^c*7^d within +" << ratio*100.0
+         << "%, time = fwd+inv transform, mean of warm runs)\n"
+         << std::left << std::setw(static_cast<int>(width)) << "Benchmark"
+         << "  " << std::setw(16) << "Extent" << std::right
+         << std::setw(5) << "Dim"
+         << std::setw(10) << "Padded"
+         << std::setw(14) << "Time [ms]"
+         << std::setw(14) << "Padded [ms]"
+         << std::setw(10) << "Speedup"
+         << std::setw(14) << "Extra memory"
+         << "\n";
+
+      for(const auto& b : order_) {
+        const auto& entries = benchmarks_.at(b);
+        for(const auto& e : extents) {
+          auto original = entries.find(e);
+          if(original == entries.end())
+            continue;
+          for(size_t d = 0; d < e.size(); ++d) {
+            if(!searched(e[d]))
+              continue;
+            // fastest measured candidate of dimension d
+            const Entry* best = nullptr;
+            size_t best_size = 0;
+            for(size_t c : candidates(e[d], ratio)) {
+              auto p = e;
+              p[d] = c;
+              auto it = entries.find(p);
+              if(it != entries.end() && (!best || it->second.time < best->time)) {
+                best = &it->second;
+                best_size = c;
+              }
+            }
+            ss << std::left << std::setw(static_cast<int>(width)) << b
+               << "  " << std::setw(16) << format(e) << std::right
+               << std::setw(5) << d
+               << std::setw(10);
+            if(!best) {
+              ss << "-" << std::setw(14) << std::setprecision(6) << original->second.time << "\n";
+              continue;
+            }
+            const double extra = original->second.bytes > 0
+              ? 100.0*(static_cast<double>(best->bytes)/static_cast<double>(original->second.bytes)-1.0)
+              : 0.0;
+            std::stringstream speedup;
+            speedup << std::fixed << std::setprecision(2) << original->second.time/best->time << "x";
+            std::stringstream memory;
+            memory << std::showpos << std::fixed << std::setprecision(1) << extra << "%";
+            ss << best_size
+               << std::setw(14) << std::setprecision(6) << original->second.time
+               << std::setw(14) << best->time
+               << std::setw(10) << speedup.str()
+               << std::setw(14) << memory.str()
+               << "\n";
+          }
+        }
+      }
+      ss << "; Speedup < 1 = padding does not pay off, Extra memory = allocated buffers of the padded transform\n";
+      os << ss.str() << std::flush;
+    }
+
+  private:
+    struct Entry {
+      double time;
+      size_t bytes;
+    };
+
+    mutable std::mutex mutex_;
+    /// benchmarks in order of the first measurement
+    std::vector<std::string> order_;
+    std::map<std::string, std::map<std::vector<size_t>, Entry> > benchmarks_;
+
+    static std::string format(const std::vector<size_t>& e) {
+      std::stringstream ss;
+      for(size_t k = 0; k < e.size(); ++k)
+        ss << (k ? "x" : "") << e[k];
+      return ss.str();
+    }
+  };
+
+} // gearshifft
+
+#endif /* PADDING_ADVISOR_HPP_ */
@@ -0,0 +1,106 @@
+#ifndef PARALLEL_HPP_
+#define PARALLEL_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace gearshifft {
+
+  /**
+   * Simple fork-join loops for the benchmark harness (test data, validation).
+   * Independent from the threading of the FFT libraries, so it can be used
+   * by every back-end.
+   */
+  namespace parallel {
+
+    /// minimum number of elements per thread, smaller loops run serially
+    constexpr size_t DefaultGrainSize = size_t(1)<<16;
+
+    namespace detail {
+      /// queried once, hardware_concurrency() reads the system configuration on every call
+      inline size_t& thread_count() {
+        static size_t n = std::max<size_t>(1, std::thread::hardware_concurrency());
+        return n;
+      }
+    }
+
+    /// number of threads of the loops, all hardware threads unless limited by set_threads()
+    inline size_t threads() {
+      return detail::thread_count();
+    }
+
+    /**
+     * Limits the threads of the loops, e.g. to the CPU threads of a back-end (-n).
+     * \param n Number of threads, 0 = all hardware threads.
+     */
+    inline void set_threads(size_t n) {
+      const size_t hw = std::max<size_t>(1, std::thread::hardware_concurrency());
+      detail::thread_count() = n == 0 ? hw : std::min(n, hw);
+    }
+
+    /// number of chunks for n elements
+    inline size_t chunks(size_t n, size_t grain = DefaultGrainSize) {
+      return std::max<size_t>(1, std::min(threads(), n/std::max<size_t>(grain,1)));
+    }
+
+    /**
+     * Splits [0,n) into nchunks contiguous chunks and calls f(chunk, begin, end)
+     * for each chunk on its own thread. f must not throw.
+     */
+    template<typename TFunc>
+    void for_each_chunk(size_t n, size_t nchunks, TFunc f) {
+      const size_t chunk = (n+nchunks-1)/nchunks;
+      std::vector<std::thread> workers;
+      workers.reserve(nchunks-1);
+      for(size_t c=1; c<nchunks; ++c) {
+        const size_t begin = std::min(n, c*chunk);
+        const size_t end = std::min(n, begin+chunk);
+        workers.emplace_back(f, c, begin, end);
+      }
+      f(static_cast<size_t>(0), static_cast<size_t>(0), std::min(n, chunk));
+      for(auto& w : workers)
+        w.join();
+    }
+
+    /**
+     * Splits [0,n) into contiguous chunks and calls f(begin, end) for each
+     * chunk on its own thread. f must not throw.
+     */
+    template<typename TFunc>
+    void for_chunks(size_t n, TFunc f, size_t grain = DefaultGrainSize) {
+      const size_t nchunks = chunks(n, grain);
+      if(nchunks == 1) {
+        f(static_cast<size_t>(0), n);
+        return;
+      }
+      for_each_chunk(n, nchunks, [&f](size_t, size_t begin, size_t end) {
+          f(begin, end);
+        });
+    }
+
+    /**
+     * Parallel reduction over [0,n).
+     * f(begin, end) returns the partial result of a chunk,
+     * partial results are combined in chunk order by combine(a, b).
+     */
+    template<typename T, typename TFunc, typename TCombine>
+    T reduce(size_t n, T init, TFunc f, TCombine combine, size_t grain = DefaultGrainSize) {
+      const size_t nchunks = chunks(n, grain);
+      if(nchunks == 1)
+        return combine(init, f(static_cast<size_t>(0), n));
+      std::vector<T> partial(nchunks, init);
+      for_each_chunk(n, nchunks, [&f, &partial](size_t c, size_t begin, size_t end) {
+          partial[c] = f(begin, end);
+        });
+      T result = init;
+      for(const auto& p : partial)
+        result = combine(result, p);
+      return result;
+    }
+
+  } // parallel
+} // gearshifft
+
+#endif /* PARALLEL_HPP_ */
@@ -13,6 +13,33 @@
 namespace gearshifft
 {
 
+  /// true if e is a power of b
+  inline bool powerOf(size_t e, double b) {
+    if(e==0)
+      return false;
+    double a = static_cast<double>(e);
+    double p = floor(log(a)/log(b)+0.5);
+    return fabs(pow(b,p)-a)<0.0001;
+  }
+
+  /// true if e has a prime factor > 7 (or e is 1)
+  inline bool isNotOnlyDivBy_2_3_5_7(size_t e) {
+    if(e==2 || e==3 || e==5 || e==7)
+      return false;
+    size_t t = e;
+    size_t sqr = static_cast<size_t>(sqrt(e));
+    for( size_t d=2; d<=sqr; ++d ) {
+      // if e contains divisors > 7
+      if( e%d == 0 && d>7 )
+        return true;
+      // e = e / d^q
+      while( e%d == 0 ) {
+        e /= d;
+      }
+    }
+    return e==t || e>7; // e might be a prime or a divisor>7
+  }
+
 /** Result data generated after a benchmark has completed the runs
  */
   template<int T_NumberRuns, int T_NumberValues>
@@ -24,7 +51,7 @@ namespace gearshifft
              bool isInplace,
              typename T_Precision,
              size_t T_NDim>
-    void init(const std::array<size_t, T_NDim>& ce) {
+    void init(const std::array<size_t, T_NDim>& ce, const std::string& benchmark) {
       static size_t sid = 0;
       id_ = sid++;
       total_ = 1;
@@ -38,8 +65,12 @@ namespace gearshifft
       isInplace_ = isInplace;
       isComplex_ = isComplex;
       precision_ = ToString<T_Precision>::value();
+      benchmark_ = benchmark;
       error_.clear();
       errorRun_ = -1;
+      skipped_.clear();
+      skippedInfo_.clear();
+      variant_.clear();
     }
 
     /**
@@ -74,6 +105,11 @@ namespace gearshifft
       values_[run_][idx] = val;
     }
 
+    /// sets values of all runs, e.g. results gathered from another process
+    void setValues(const ValuesT& values) {
+      values_ = values;
+    }
+
     void setError(int run, const std::string& what) {
       assert(errorRun_<T_NumberRuns);
       errorRun_ = run;
@@ -83,6 +119,23 @@ namespace gearshifft
       error_ = std::regex_replace(error_,e,"$2$3");
     }
 
+    /**
+     * Marks benchmark as not executed, e.g. reason="memory" when the predicted
+     * memory footprint exceeds the memory budget.
+     */
+    void setSkipped(const std::string& reason, const std::string& what) {
+      skipped_ = reason;
+      skippedInfo_ = what;
+    }
+
+    /**
+     * Sets variant of a benchmark, if a benchmark is run in several
+     * configurations (e.g. "ftz-daz=on").
+     */
+    void setVariant(const std::string& variant) {
+      variant_ = variant;
+    }
+
     /* getters */
 
 
@@ -93,11 +146,16 @@ namespace gearshifft
       return values_[run_][idx];
     }
 
+    const ValuesT& getValues() const {
+      return values_;
+    }
+
     size_t getID() const {
       return id_;
     }
 
     std::string getPrecision() const { return precision_; }
+    const std::string& getBenchmark() const { return benchmark_; }
     size_t getDim() const { return dim_; }
     size_t getDimKind() const { return dimkind_; }
     std::string getDimKindStr() const {
@@ -116,6 +174,10 @@ namespace gearshifft
     bool hasError() const { return error_.empty()==false; }
     const std::string& getError() const { return error_; }
     int getErrorRun() const { return errorRun_; }
+    bool isSkipped() const { return skipped_.empty()==false; }
+    const std::string& getSkipReason() const { return skipped_; }
+    const std::string& getSkipInfo() const { return skippedInfo_; }
+    const std::string& getVariant() const { return variant_; }
 
   private:
     /// result object id
@@ -137,37 +199,18 @@ namespace gearshifft
     bool isComplex_ = false;
     /// Precision as string
     const char* precision_;
+    /// Title of the FFT benchmark (e.g. Inplace_Bluestein_Complex)
+    std::string benchmark_;
     /// Error message
     std::string error_;
     /// Run where error occurred
     int errorRun_;
-
-  private:
-    bool powerOf(size_t e, double b) {
-      if(e==0)
-        return false;
-      double a = static_cast<double>(e);
-      double p = floor(log(a)/log(b)+0.5);
-      return fabs(pow(b,p)-a)<0.0001;
-    }
-
-    bool isNotOnlyDivBy_2_3_5_7(size_t e) {
-      if(e==2 || e==3 || e==5 || e==7)
-        return false;
-      size_t t = e;
-      size_t sqr = static_cast<size_t>(sqrt(e));
-      for( size_t d=2; d<=sqr; ++d ) {
-        // if e contains divisors > 7
-        if( e%d == 0 && d>7 )
-          return true;
-        // e = e / d^q
-        while( e%d == 0 ) {
-          e /= d;
-        }
-      }
-      return e==t || e>7; // e might be a prime or a divisor>7
-    }
-
+    /// Reason why benchmark was skipped (empty if it was executed)
+    std::string skipped_;
+    /// Details why benchmark was skipped
+    std::string skippedInfo_;
+    /// Configuration variant of benchmark (empty = default)
+    std::string variant_;
   };
 }
 
@@ -185,7 +185,16 @@ namespace gearshifft {
              << ", Dim="<<result.getDim()
              << ", Kind="<<result.getDimKindStr()<<" ("<<result.getDimKind()<<")"
              << ", Ext="<<result.getExtents()
-             << "\n";
+             << ", Benchmark="<<result.getBenchmark();
+      if(!result.getVariant().empty())
+        stream << ", Variant="<<result.getVariant();
+      stream << "\n";
+      if(result.isSkipped()) {
+        stream << " Skipped: "<<result.getSkipReason()
+               << " ("<<result.getSkipInfo()<<")"
+               << "\n";
+        return;
+      }
       if(result.hasError()) {
         stream << " Error at run="<<result.getErrorRun()
                << ": "<<result.getError()
@@ -227,7 +236,7 @@ namespace gearshifft {
       }
       // header
       stream << "\"library\",\"inplace\",\"complex\",\"precision\",\"dim\",\"kind\""
-             << ",\"nx\",\"ny\",\"nz\",\"run\",\"id\",\"success\"";
+             << ",\"nx\",\"ny\",\"nz\",\"run\",\"id\",\"success\",\"variant\",\"benchmark\"";
       for(auto ival=0; ival<T_NumberValues; ++ival) {
         stream << SEP << '"' << static_cast<RecordType>(ival) << '"';
       }
@@ -253,7 +262,9 @@ namespace gearshifft {
                << run << SEP
                << result.getID();
         // was run successfull?
-        if(result.hasError() && result.getErrorRun()<=run) {
+        if(result.isSkipped()) {
+          stream << SEP << "\"Skipped: " << result.getSkipReason() << "\"";
+        } else if(result.hasError() && result.getErrorRun()<=run) {
           if(result.getErrorRun()==run)
             stream << SEP << "\"" <<result.getError() << "\"";
           else
@@ -265,6 +276,9 @@ namespace gearshifft {
             stream << SEP << "\"" << "Success" << "\"";
         }
 
+        stream << SEP << "\"" << result.getVariant() << "\""
+               << SEP << "\"" << result.getBenchmark() << "\"";
+
         // measured time and size values
         for(auto ival=0; ival<T_NumberValues; ++ival) {
           stream << SEP << result.getValue(ival);
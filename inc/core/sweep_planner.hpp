@@ -0,0 +1,261 @@
+#ifndef SWEEP_PLANNER_HPP_
+#define SWEEP_PLANNER_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace gearshifft {
+
+  /**
+   * Predicted resources of a single benchmark (all runs incl. warmups).
+   */
+  struct BenchmarkPrediction {
+    /// host memory: test data, data buffer and host-resident client buffers
+    size_t host = 0;
+    /// buffers allocated by the FFT client (get_allocation_size())
+    size_t backend = 0;
+    /// size of one data transfer (get_transfer_size())
+    size_t transfer = 0;
+    /// client buffers live in host memory
+    bool host_resident = false;
+    /// predicted wall time of all runs in seconds
+    double time = 0.0;
+    /// time was taken from a previous result file (otherwise N*log(N) model)
+    bool from_reference = false;
+
+    /// memory footprint on host and device
+    size_t total_bytes() const {
+      return host_resident ? host : host + backend;
+    }
+  };
+
+  /**
+   * Predicts runtimes of benchmarks and collects the predictions of a dry run.
+   *
+   * Runtimes are taken from a previous result file, if it contains the same
+   * benchmark (precision, benchmark title, variant and extents). Otherwise a
+   * N*log2(N) model is used, whose coefficient is fitted to the previous results
+   * of the same precision and benchmark or falls back to DefaultNanosecondsPerNLogN.
+   */
+  class SweepPlanner {
+  public:
+    /// roughly 2x 5*N*log2(N) flop at 1 GFLOP/s per run
+    static constexpr double DefaultNanosecondsPerNLogN = 10.0;
+
+    /**
+     * Reads per-run times (Time_Total) from a gearshifft csv result file.
+     * Columns are looked up by their header names. Files without the columns
+     * benchmark and variant refer to the native transforms in their default
+     * configuration.
+     */
+    void loadReference(const std::string& fname, int number_warmups) {
+      std::lock_guard<std::mutex> g(mutex_);
+      reference_.clear();
+      coefficients_.clear();
+      if(fname.empty())
+        return;
+      std::ifstream fs(fname);
+      if(!fs.good())
+        throw std::runtime_error("Could not open result file '"+fname+"' for runtime prediction.");
+
+      std::string line;
+      std::map<std::string, size_t> columns;
+      std::map<Key, std::pair<double,size_t> > sums;
+      while(std::getline(fs, line)) {
+        if(line.empty() || line[0]==';')
+          continue;
+        auto tokens = splitCSV(line);
+        if(columns.empty()) { // header
+          for(size_t i=0; i<tokens.size(); ++i)
+            columns[tokens[i]] = i;
+          for(const char* name : {"inplace", "complex", "precision", "nx", "ny", "nz",
+                                  "run", "success", "Time_Total [ms]"})
+            if(columns.find(name) == columns.end())
+              throw std::runtime_error("Result file '"+fname+"' has no column "+name+".");
+          continue;
+        }
+        if(tokens.size() < columns.size())
+          continue;
+        auto column = [&](const char* name) -> const std::string& {
+          return tokens[columns.at(name)];
+        };
+        // only successful runs after warmups
+        if(column("success")!="Success" || std::stoi(column("run"))<number_warmups)
+          continue;
+        std::string benchmark = columns.count("benchmark") ? column("benchmark") : std::string();
+        if(benchmark.empty())
+          benchmark = column("inplace") + "_" + column("complex");
+        const std::string variant = columns.count("variant") ? column("variant") : std::string();
+        Key key = makeKey(column("precision"), benchmark, variant,
+                          {{std::stoull(column("nx")), std::stoull(column("ny")), std::stoull(column("nz"))}});
+        auto& s = sums[key];
+        s.first += std::stod(column("Time_Total [ms]"));
+        s.second += 1;
+      }
+
+      std::map<std::string, std::vector<double> > ratios;
+      for(auto& kv : sums) {
+        double ms = kv.second.first / kv.second.second;
+        reference_[kv.first] = ms;
+        ratios[classOf(kv.first)].push_back(1.0e6*ms/nlogn(total(std::get<3>(kv.first))));
+      }
+      for(auto& kv : ratios) { // median is robust against planning outliers
+        auto& v = kv.second;
+        std::nth_element(v.begin(), v.begin()+v.size()/2, v.end());
+        coefficients_[kv.first] = v[v.size()/2];
+      }
+    }
+
+    /**
+     * Predicts runtime in seconds of nruns runs of a benchmark variant.
+     * \param benchmark Title of the benchmark (e.g. Inplace_Complex).
+     * \param variant Variant as written to the result file (empty = default).
+     * \param from_reference is set true if the benchmark was found in the reference.
+     */
+    template<size_t NDim>
+    double predictTime(const std::string& precision,
+                       const std::string& benchmark,
+                       const std::string& variant,
+                       const std::array<size_t,NDim>& extents,
+                       int nruns,
+                       bool& from_reference) const {
+      std::lock_guard<std::mutex> g(mutex_);
+      std::array<size_t,3> e = {{0,0,0}};
+      std::copy(extents.begin(), extents.end(), e.begin());
+      Key key = makeKey(precision, benchmark, variant, e);
+      auto it = reference_.find(key);
+      from_reference = it != reference_.end();
+      if(from_reference)
+        return nruns * it->second * 1.0e-3;
+
+      double ns = DefaultNanosecondsPerNLogN;
+      auto c = coefficients_.find(classOf(key));
+      if(c != coefficients_.end())
+        ns = c->second;
+      return nruns * ns * nlogn(total(e)) * 1.0e-9;
+    }
+
+    /// records a benchmark of a dry run, prune is empty if benchmark would run
+    void add(const std::string& name,
+             const BenchmarkPrediction& prediction,
+             const std::string& prune) {
+      std::lock_guard<std::mutex> g(mutex_);
+      entries_.push_back(Entry{name, prediction, prune});
+    }
+
+    /// prints all predictions and totals of the dry run
+    void report(std::ostream& os, const std::string& apptitle, int nruns) const {
+      std::lock_guard<std::mutex> g(mutex_);
+      size_t width = 9;
+      for(const auto& entry : entries_)
+        width = std::max(width, entry.name.size());
+
+      std::stringstream ss;
+      ss << "; Dry run of " << apptitle << ", RunsPerBenchmark=" << nruns << "\n"
+         << std::left << std::setw(static_cast<int>(width)) << "Benchmark" << std::right
+         << std::setw(18) << "Host [bytes]"
+         << std::setw(18) << "Backend [bytes]"
+         << std::setw(18) << "Transfer [bytes]"
+         << std::setw(16) << "Predicted [s]"
+         << "  Model/Status\n";
+
+      size_t nrun = 0;
+      size_t peak_host = 0;
+      size_t peak_backend = 0;
+      double time = 0.0;
+      for(const auto& entry : entries_) {
+        const auto& p = entry.prediction;
+        ss << std::left << std::setw(static_cast<int>(width)) << entry.name << std::right
+           << std::setw(18) << p.host
+           << std::setw(18) << p.backend
+           << std::setw(18) << p.transfer
+           << std::setw(16) << std::setprecision(6) << p.time
+           << "  " << (p.from_reference ? "reference" : "nlogn");
+        if(entry.prune.empty()) {
+          ++nrun;
+          peak_host = std::max(peak_host, p.host);
+          peak_backend = std::max(peak_backend, p.backend);
+          time += p.time;
+        } else {
+          ss << ", Skipped: " << entry.prune;
+        }
+        ss << "\n";
+      }
+      ss << "; Benchmarks: " << nrun << " of " << entries_.size()
+         << " (" << entries_.size()-nrun << " pruned)\n"
+         << "; Peak host memory [bytes]: " << peak_host << "\n"
+         << "; Peak backend memory [bytes]: " << peak_backend << "\n"
+         << "; Predicted total time [s]: " << time << "\n";
+      os << ss.str() << std::flush;
+    }
+
+  private:
+    /// precision, benchmark, variant, extents
+    using Key = std::tuple<std::string, std::string, std::string, std::array<size_t,3> >;
+
+    struct Entry {
+      std::string name;
+      BenchmarkPrediction prediction;
+      std::string prune;
+    };
+
+    mutable std::mutex mutex_;
+    std::map<Key, double> reference_; // per-run time in ms
+    std::map<std::string, double> coefficients_; // ns per N*log2(N)
+    std::vector<Entry> entries_;
+
+    static Key makeKey(const std::string& precision, const std::string& benchmark,
+                       const std::string& variant, const std::array<size_t,3>& e) {
+      std::array<size_t,3> k = e;
+      for(auto& v : k) // 1D/2D extents are written as n,0,0 or n,1,1
+        if(v==1) v = 0;
+      return Key(precision, benchmark, variant, k);
+    }
+
+    /// variants of a benchmark share the coefficient of the N*log2(N) model
+    static std::string classOf(const Key& key) {
+      return std::get<0>(key) + "/" + std::get<1>(key);
+    }
+
+    static size_t total(const std::array<size_t,3>& e) {
+      size_t n = 1;
+      for(auto v : e)
+        if(v>0) n *= v;
+      return n;
+    }
+
+    static double nlogn(size_t n) {
+      double N = static_cast<double>(std::max<size_t>(n,2));
+      return N*std::log2(N);
+    }
+
+    /// splits csv line, removes quotes
+    static std::vector<std::string> splitCSV(const std::string& line) {
+      std::vector<std::string> tokens(1);
+      bool quoted = false;
+      for(char c : line) {
+        if(c=='"')
+          quoted = !quoted;
+        else if(c==',' && !quoted)
+          tokens.emplace_back();
+        else
+          tokens.back() += c;
+      }
+      return tokens;
+    }
+  };
+
+} // gearshifft
+
+#endif /* SWEEP_PLANNER_HPP_ */
@@ -3,6 +3,8 @@
 
 #include "types.hpp"
 
+#include <type_traits>
+
 namespace gearshifft {
 
   template <typename T_Precision>
@@ -29,17 +31,73 @@ namespace gearshifft {
     }
   };
 
-// SFINAE test if T has title method
+  namespace detail {
+    template <typename...>
+    struct make_void { using type = void; };
+
+    template <typename AlwaysVoid, template <typename> class Op, typename T>
+    struct detector : std::false_type {};
+
+    template <template <typename> class Op, typename T>
+    struct detector<typename make_void<Op<T> >::type, Op, T> : std::true_type {};
+
+    template <typename C> using title_t = decltype(&C::Title);
+    template <typename C> using uses_host_memory_t = decltype(&C::UsesHostMemory);
+    template <typename C> using plan_cache_t = decltype(&C::get_plan_cache_hits);
+    template <typename C> using chirp_cache_t = decltype(&C::get_chirp_cache_hits);
+    template <typename C> using communication_t = decltype(&C::get_communication_time);
+    template <typename C> using stage_times_t = decltype(&C::get_stage_times);
+    template <typename C> using spectrum_t = decltype(&C::get_spectrum);
+    template <typename C> using convolution_t = decltype(&C::IsConvolution);
+    template <typename C> using variants_t = decltype(&C::variants);
+    template <typename C> using enabled_t = decltype(&C::enabled);
+    template <typename C> using normalization_t = decltype(&C::normalization);
+    template <typename C> using variant_group_t = decltype(&C::variant_group);
+    template <typename C> using variant_sweep_t = decltype(&C::variant_sweep);
+    template <typename C> using unsupported_t = decltype(&C::unsupported);
+  }
+
+/**
+ * Detection idiom: true_type if Op<T> is well-formed, i.e. T has the member
+ * named by Op. The traits below tell which optional hooks a client provides.
+ */
+  template <template <typename> class Op, typename T>
+  using is_detected = detail::detector<void, Op, T>;
+
+  /// T has title method
+  template <typename T> using has_title = is_detected<detail::title_t, T>;
+  /// FFT client counts plans found in a plan cache (get_plan_cache_hits/misses)
+  template <typename T> using has_plan_cache = is_detected<detail::plan_cache_t, T>;
+  /// FFT client counts chirps found in a chirp cache, e.g. Bluestein (get_chirp_cache_hits/misses)
+  template <typename T> using has_chirp_cache = is_detected<detail::chirp_cache_t, T>;
+  /// FFT client measures its communication, e.g. all-to-all of MPI (get_communication_time)
+  template <typename T> using has_communication = is_detected<detail::communication_t, T>;
+  /// FFT client measures the stages of its transforms (get_stage_times())
+  template <typename T> using has_stage_times = is_detected<detail::stage_times_t, T>;
+  /// FFT client exposes its spectrum in host memory (get_spectrum(), get_spectrum_size())
+  template <typename T> using has_spectrum = is_detected<detail::spectrum_t, T>;
+  /// FFT kind (or FFT wrapper) is a convolution benchmark (IsConvolution)
+  template <typename T> using is_convolution = is_detected<detail::convolution_t, T>;
+  /// FFT client provides plan variants (static variants() and select_variant())
+  template <typename T> using has_variants = is_detected<detail::variants_t, T>;
+  /// FFT client tells whether it supports the FFT kind (static enabled())
+  template <typename T> using has_enabled = is_detected<detail::enabled_t, T>;
+  /// FFT client provides the round trip scaling (static normalization(extents))
+  template <typename T> using has_normalization = is_detected<detail::normalization_t, T>;
+  /// FFT client groups its variants by transform (static variant_group(variant))
+  template <typename T> using has_variant_group = is_detected<detail::variant_group_t, T>;
+  /// FFT client sweeps a buffer layout over its variants (static variant_sweep(variant))
+  template <typename T> using has_variant_sweep = is_detected<detail::variant_sweep_t, T>;
+  /// FFT client rejects extents of its selected variant (static unsupported(extents))
+  template <typename T> using has_unsupported = is_detected<detail::unsupported_t, T>;
+
+  /// FFT client keeps its buffers in host memory (static UsesHostMemory), false if not given
+  template <typename T, bool = is_detected<detail::uses_host_memory_t, T>::value>
+  struct uses_host_memory : std::false_type {};
+
   template <typename T>
-  class has_title
-  {
-    typedef char one;
-    typedef long two;
-    template <typename C> static one test( decltype(&C::Title) ) ;
-    template <typename C> static two test(...);
-  public:
-    enum { value = sizeof(test<T>(0)) == sizeof(char) };
-  };
+  struct uses_host_memory<T, true> : std::integral_constant<bool, T::UsesHostMemory> {};
+
 /**
  * Trait to get precision type of Real or Complex data type.
  */
@@ -0,0 +1,147 @@
+#ifndef TUNING_TABLE_HPP_
+#define TUNING_TABLE_HPP_
+
+#include <algorithm>
+#include <array>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace gearshifft {
+
+  /**
+   * Measured configurations (plan variants) per extent, written as csv file
+   * (--tuning-table) to be loaded by applications.
+   *
+   * Configurations of in-place and out-of-place transforms of the same
+   * extent, precision and real/complex kind are ranked together,
+   * the fastest is marked as best.
+   */
+  class TuningTable {
+  public:
+
+    struct Entry {
+      std::string precision;
+      bool complex = false;
+      size_t dim = 0;
+      std::array<size_t,3> extents = {{0, 0, 0}};
+      /// "Inplace" or "Outplace"
+      std::string placement;
+      std::string config;
+      /// planning time of forward and inverse plan [ms]
+      double plan = 0.0;
+      /// forward and inverse transform [ms], mean of warm runs (pruned: best probe)
+      double time = 0.0;
+      /// ok, pruned or error
+      std::string status;
+    };
+
+    void add(const Entry& entry) {
+      std::lock_guard<std::mutex> g(mutex_);
+      entries_.push_back(entry);
+    }
+
+    bool empty() const {
+      std::lock_guard<std::mutex> g(mutex_);
+      return entries_.empty();
+    }
+
+    /// writes table sorted by extent and time, best configuration per extent is flagged
+    void write(const std::string& fname, const std::string& apptitle) const {
+      std::lock_guard<std::mutex> g(mutex_);
+      std::ofstream fs(fname, std::ofstream::out);
+      if(!fs.good())
+        throw std::runtime_error("Tuning table '"+fname+"' could not be written.");
+      std::time_t now = std::time(nullptr);
+      fs << "; gearshifft tuning table, \"" << apptitle << "\", " << now << "\n"
+         << "\"precision\",\"complex\",\"dim\",\"nx\",\"ny\",\"nz\",\"placement\",\"config\","
+         << "\"Time_Plan [ms]\",\"Time_FFT_IFFT [ms]\",\"status\",\"best\"\n";
+      for(const auto& e : sorted()) {
+        fs << "\"" << e.first->precision << "\","
+           << "\"" << (e.first->complex ? "Complex" : "Real") << "\","
+           << e.first->dim << ","
+           << e.first->extents[0] << "," << e.first->extents[1] << "," << e.first->extents[2] << ","
+           << "\"" << e.first->placement << "\","
+           << "\"" << e.first->config << "\","
+           << e.first->plan << ","
+           << e.first->time << ","
+           << "\"" << e.first->status << "\","
+           << (e.second ? 1 : 0) << "\n";
+      }
+    }
+
+    /// prints best configuration per extent
+    void report(std::ostream& os, const std::string& apptitle, const std::string& fname) const {
+      std::lock_guard<std::mutex> g(mutex_);
+      std::stringstream ss;
+      size_t ntried = 0;
+      size_t npruned = 0;
+      ss << "; Best configurations of " << apptitle << " (tuning table: " << fname << ")\n";
+      for(const auto& e : sorted()) {
+        ++ntried;
+        if(e.first->status == "pruned")
+          ++npruned;
+        if(!e.second)
+          continue;
+        std::stringstream extents;
+        extents << e.first->extents[0];
+        for(size_t k=1; k<e.first->dim; ++k)
+          extents << "x" << e.first->extents[k];
+        ss << std::left << std::setw(8) << e.first->precision
+           << std::setw(9) << (e.first->complex ? "Complex" : "Real")
+           << std::setw(16) << extents.str()
+           << std::setw(10) << e.first->placement
+           << std::right << std::setw(14) << std::setprecision(6) << e.first->time << " ms  "
+           << e.first->config << "\n";
+      }
+      ss << "; Configurations: " << ntried << " (" << npruned << " pruned)\n";
+      os << ss.str() << std::flush;
+    }
+
+  private:
+    mutable std::mutex mutex_;
+    std::vector<Entry> entries_;
+
+    using Key = std::tuple<std::string, bool, size_t, std::array<size_t,3> >;
+
+    static Key makeKey(const Entry& e) {
+      return std::make_tuple(e.precision, e.complex, e.dim, e.extents);
+    }
+
+    /// entries sorted by extent and time, with flag for the best entry of each extent
+    std::vector<std::pair<const Entry*, bool> > sorted() const {
+      std::vector<const Entry*> order;
+      for(const auto& e : entries_)
+        order.push_back(&e);
+      std::stable_sort(order.begin(), order.end(), [](const Entry* lhs, const Entry* rhs) {
+          const auto kl = makeKey(*lhs);
+          const auto kr = makeKey(*rhs);
+          if(kl != kr)
+            return kl < kr;
+          const bool okl = lhs->status == "ok";
+          const bool okr = rhs->status == "ok";
+          if(okl != okr)
+            return okl;
+          return lhs->time < rhs->time;
+        });
+      std::vector<std::pair<const Entry*, bool> > result;
+      for(size_t k=0; k<order.size(); ++k) {
+        const bool best = order[k]->status == "ok"
+          && (k==0 || makeKey(*order[k-1]) != makeKey(*order[k]));
+        result.emplace_back(order[k], best);
+      }
+      return result;
+    }
+  };
+
+} // gearshifft
+
+#endif /* TUNING_TABLE_HPP_ */
@@ -9,6 +9,7 @@
 
 #include "complex-half.hpp"
 
+#include <boost/mpl/joint_view.hpp>
 #include <boost/mpl/list.hpp>
 
 #include <algorithm>
@@ -31,6 +32,10 @@ namespace gearshifft {
   template<typename... Types>
   using List = boost::mpl::list<Types...>;
 
+/// concatenation of two lists, a List takes at most BOOST_MPL_LIMIT_LIST_SIZE (20) types
+  template<typename T_List1, typename T_List2>
+  using JoinedList = boost::mpl::joint_view<T_List1, T_List2>;
+
   namespace interpret_as {
     template<typename T_Extents>
     T_Extents column_major(T_Extents e) {
@@ -114,6 +119,23 @@ namespace gearshifft {
     DevTransferSize,
     Deviation,
     Mismatches,
+    SubnormalsInput,
+    SubnormalsOutput,
+    DataPreparation,
+    Validated,
+    PlanCacheHits,
+    PlanCacheMisses,
+    Communication,
+    CommunicationShare,
+    StageFFT,
+    StageTranspose,
+    StageTwiddle,
+    StagePacking,
+    Multiply,
+    Convolution,
+    MultiplyShare,
+    ChirpCacheHits,
+    ChirpCacheMisses,
     NrRecords_
   };
 
@@ -134,6 +156,23 @@ namespace gearshifft {
     case RecordType::DevTransferSize: return os << "Size_DeviceTransfer [bytes]";
     case RecordType::Deviation: return os << "Error_StandardDeviation";
     case RecordType::Mismatches: return os << "Error_Mismatches";
+    case RecordType::SubnormalsInput: return os << "Count_SubnormalsInput";
+    case RecordType::SubnormalsOutput: return os << "Count_SubnormalsOutput";
+    case RecordType::DataPreparation: return os << "Time_DataPreparation [ms]";
+    case RecordType::Validated: return os << "Count_Validated";
+    case RecordType::PlanCacheHits: return os << "Count_PlanCacheHits";
+    case RecordType::PlanCacheMisses: return os << "Count_PlanCacheMisses";
+    case RecordType::Communication: return os << "Time_Communication [ms]";
+    case RecordType::CommunicationShare: return os << "Share_Communication";
+    case RecordType::StageFFT: return os << "Time_StageFFT [ms]";
+    case RecordType::StageTranspose: return os << "Time_StageTranspose [ms]";
+    case RecordType::StageTwiddle: return os << "Time_StageTwiddle [ms]";
+    case RecordType::StagePacking: return os << "Time_StagePacking [ms]";
+    case RecordType::Multiply: return os << "Time_Multiply [ms]";
+    case RecordType::Convolution: return os << "Time_Convolution [ms]";
+    case RecordType::MultiplyShare: return os << "Share_Multiply";
+    case RecordType::ChirpCacheHits: return os << "Count_ChirpCacheHits";
+    case RecordType::ChirpCacheMisses: return os << "Count_ChirpCacheMisses";
     case RecordType::NrRecords_:
     default:
       ;
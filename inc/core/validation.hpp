@@ -0,0 +1,112 @@
+#ifndef VALIDATION_HPP_
+#define VALIDATION_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace gearshifft {
+
+  /**
+   * Which runs and elements are compared to the input data (--validate).
+   *
+   * Sampling policies check m elements per run. m is chosen so, that a
+   * result with a mismatch rate of at least `rate` is detected with
+   * probability `confidence`: 1-(1-rate)^m >= confidence.
+   */
+  class ValidationPolicy {
+  public:
+    enum class Mode { Every, FirstLast, Strided, Random };
+
+    ValidationPolicy() = default;
+
+    ValidationPolicy(const std::string& mode, double confidence, double rate)
+      : confidence_(confidence), rate_(rate) {
+      if(mode == "every")
+        mode_ = Mode::Every;
+      else if(mode == "first-last")
+        mode_ = Mode::FirstLast;
+      else if(mode == "strided")
+        mode_ = Mode::Strided;
+      else if(mode == "random")
+        mode_ = Mode::Random;
+      else
+        throw std::runtime_error("Invalid validation policy (every, first-last, strided or random).");
+      if(confidence_ <= 0.0 || confidence_ >= 1.0 || rate_ <= 0.0 || rate_ >= 1.0)
+        throw std::runtime_error("Validation confidence and rate must be in (0,1).");
+    }
+
+    Mode mode() const {
+      return mode_;
+    }
+
+    bool sampled() const {
+      return mode_ == Mode::Strided || mode_ == Mode::Random;
+    }
+
+    /// returns false if run is not validated at all
+    bool validates(int run, int nruns) const {
+      if(mode_ == Mode::FirstLast)
+        return run == 0 || run == nruns-1;
+      return true;
+    }
+
+    /// number of sampled elements out of size elements
+    size_t sampleSize(size_t size) const {
+      if(!sampled())
+        return size;
+      const double m = std::ceil(std::log1p(-confidence_)/std::log1p(-rate_));
+      return std::min(size, std::max<size_t>(2, static_cast<size_t>(m)));
+    }
+
+    /**
+     * Element indices to be validated in a run (sorted).
+     * Strided samples start at a different offset for each run, random
+     * samples use a seed depending on the run.
+     */
+    std::vector<size_t> sample(size_t size, int run) const {
+      const size_t m = sampleSize(size);
+      std::vector<size_t> indices(m);
+      if(mode_ == Mode::Strided) {
+        const size_t stride = size/m;
+        const size_t offset = static_cast<size_t>(run) % stride;
+        for(size_t k=0; k<m; ++k)
+          indices[k] = offset + k*stride;
+      } else {
+        std::mt19937_64 gen(static_cast<unsigned long long>(run)+1);
+        std::uniform_int_distribution<size_t> dist(0, size-1);
+        for(auto& i : indices)
+          i = dist(gen);
+        std::sort(indices.begin(), indices.end());
+      }
+      return indices;
+    }
+
+    /// policy as written to the result file
+    std::string str() const {
+      std::stringstream ss;
+      switch(mode_) {
+      case Mode::Every: ss << "every"; break;
+      case Mode::FirstLast: ss << "first-last"; break;
+      case Mode::Strided: ss << "strided"; break;
+      case Mode::Random: ss << "random"; break;
+      }
+      if(sampled())
+        ss << " (confidence=" << confidence_ << ", rate=" << rate_ << ")";
+      return ss.str();
+    }
+
+  private:
+    Mode mode_ = Mode::Every;
+    double confidence_ = 0.99;
+    double rate_ = 1e-4;
+  };
+
+} // gearshifft
+
+#endif /* VALIDATION_HPP_ */
@@ -0,0 +1,420 @@
+#ifndef BUILTIN_HPP_
+#define BUILTIN_HPP_
+
+#include "core/types.hpp"
+#include "core/options.hpp"
+#include "core/context.hpp"
+#include "core/application.hpp"
+#include "core/timer.hpp"
+#include "core/fft.hpp"
+#include "core/benchmark_suite.hpp"
+#include "core/get_memory_size.hpp"
+#include "stockham.hpp"
+
+#include <boost/align/aligned_alloc.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace gearshifft {
+namespace builtin {
+
+  /// alignment in bytes of the FFT buffers (cache line, AVX-512 vector)
+  static constexpr size_t Alignment = 64;
+
+  class BuiltinOptions : public OptionsDefault {
+
+  public:
+
+    BuiltinOptions() : OptionsDefault() {
+      add_options()
+        ("batch", value(&batch_)->default_value("1"), "Number of transforms per plan, all transforms compute the same data. Transforms of a batch are interleaved (structure of arrays) and computed together in the vectorized loops. Comma-separated list allowed.")
+        ("codelets", value(&codelets_)->default_value("on"), "Compute sizes up to 64 with factors 2, 3 and 5 by codelets generated at compile time (on, off or on,off to compare both).");
+    }
+
+    /**
+     * Variant labels of --batch and --codelets, e.g. "batch-soa=64;codelets=off".
+     * The batch is labeled batch-soa, as its transforms are interleaved and not
+     * contiguous like the batch=<n> transforms of gearshifft_fftw.
+     * Empty for the defaults.
+     */
+    std::vector<std::string> variants() const {
+      std::vector<std::string> result = {""};
+      if(batch_ != "1") {
+        add_variant(result, "batch-soa", batch_, [](const std::string& v) {
+            size_t pos = 0;
+            unsigned long long b = 0;
+            try {
+              b = std::stoull(v, &pos);
+            } catch(const std::logic_error&) {
+              pos = 0;
+            }
+            return pos > 0 && pos == v.size() && b > 0;
+          });
+      }
+      if(codelets_ != "on") {
+        add_variant(result, "codelets", codelets_, [](const std::string& v) {
+            return v == "on" || v == "off";
+          });
+      }
+      if(result.size() == 1 && result.front().empty())
+        return {};
+      return result;
+    }
+
+  private:
+
+    /// crosses labels with the values of an option list
+    template<typename T_Valid>
+    static void add_variant(std::vector<std::string>& labels,
+                            const std::string& key,
+                            const std::string& list,
+                            T_Valid valid) {
+      std::vector<std::string> values;
+      std::stringstream ss(list);
+      std::string value;
+      while(std::getline(ss, value, ',')) {
+        if(!valid(value))
+          throw std::runtime_error("Invalid "+key+" '"+value+"'.");
+        values.push_back(key + "=" + value);
+      }
+      std::vector<std::string> result;
+      for(const auto& label : labels)
+        for(const auto& v : values)
+          result.push_back(label.empty() ? v : label + ";" + v);
+      labels = result;
+    }
+
+    std::string batch_;
+    std::string codelets_;
+  };
+
+  /**
+   * Context of the in-tree FFT implementation (single-threaded, no external library).
+   */
+  struct BuiltinContext : public ContextDefault<BuiltinOptions> {
+
+    /// configuration of the next benchmark runs, see BuiltinOptions::variants()
+    struct Config {
+      size_t batch = 1;
+      bool codelets = true;
+    };
+
+    static Config& selected() {
+      static Config config;
+      return config;
+    }
+
+    static void select_variant(const std::string& variant) {
+      Config config;
+      std::stringstream ss(variant);
+      std::string token;
+      while(std::getline(ss, token, ';')) {
+        const auto pos = token.find('=');
+        const std::string key = token.substr(0, pos);
+        const std::string value = pos == std::string::npos ? "" : token.substr(pos+1);
+        if(key == "batch-soa")
+          config.batch = std::stoul(value);
+        else if(key == "codelets")
+          config.codelets = value == "on";
+        else
+          throw std::runtime_error("Invalid builtin variant '"+variant+"'.");
+      }
+      selected() = config;
+    }
+
+    /// variants of the same batch size are compared
+    static std::string variant_group(const std::string& variant) {
+      std::stringstream ss(variant);
+      std::string token;
+      while(std::getline(ss, token, ';')) {
+        if(token.compare(0, 10, "batch-soa=") == 0)
+          return token;
+      }
+      return "";
+    }
+
+    static const std::string title() {
+      return "Builtin";
+    }
+
+    static std::string get_device_list() {
+      return "1 CPU Thread (builtin Stockham FFT).\n";
+    }
+
+    /// instruction set the butterflies have been vectorized for
+    static const char* simd() {
+#if defined(__AVX512F__)
+      return "avx512";
+#elif defined(__AVX2__)
+      return "avx2";
+#elif defined(__AVX__)
+      return "avx";
+#elif defined(__SSE2__)
+      return "sse2";
+#elif defined(__ARM_NEON)
+      return "neon";
+#else
+      return "none";
+#endif
+    }
+
+    std::string get_used_device_properties() {
+      std::ostringstream msg;
+      msg << "\"UsedThreads\"," << 1
+          << ",\"TotalMemory\"," << getMemorySize()
+          << ",\"AvailableMemory\"," << getAvailableMemorySize()
+          << ",\"SIMD\",\"" << simd() << "\"";
+      return msg.str();
+    }
+  };
+
+
+  /**
+   * Builtin plan and execution class.
+   *
+   * This class handles:
+   * - {1D, 2D, 3D} x {R2C, C2R, C2C} x {inplace, outplace} x {float, double}.
+   *
+   * Complex buffers are split (real parts followed by imaginary parts),
+   * upload and download convert from and to the interleaved host data.
+   * Transforms of a batch (--batch) are interleaved. Transforms are unnormalized.
+   */
+  template<typename TFFT, // see fft_abstract.hpp (FFT_Inplace_Real, ...)
+           typename TPrecision, // double, float
+           size_t   NDim // 1..3
+           >
+  struct BuiltinImpl
+  {
+    using Extent = std::array<std::size_t, NDim>;
+    using RealType = TPrecision;
+    using ComplexType = Real2D<TPrecision>;
+    using TransformType = Transform<TPrecision>;
+
+    static_assert(NDim > 0 && NDim < 4, "[builtin.hpp]\treceived NDim not in [1,3], currently unsupported" );
+
+    static constexpr
+    bool IsInplace = TFFT::IsInplace;
+    static constexpr
+    bool IsComplex = TFFT::IsComplex;
+    /// buffers are allocated in host memory, see FFT::footprint()
+    static constexpr
+    bool UsesHostMemory = true;
+
+    using value_type  = typename std::conditional<IsComplex,ComplexType,RealType>::type;
+
+    /// extents of the FFT input data
+    Extent extents_   = {{0}};
+    /// product of extents
+    size_t n_         = 0;
+    /// product of extents of the complex data (=FFT(input))
+    size_t n_complex_ = 0;
+
+    std::unique_ptr<TransformType> fwd_;
+    std::unique_ptr<TransformType> bwd_;
+    /// input data (real or split complex), in-place: also FFT(input)
+    RealType* data_         = nullptr;
+    /// FFT(input), split complex
+    RealType* data_complex_ = nullptr;
+    RealType* scratch_      = nullptr;
+    /// sizes in elements of RealType
+    size_t data_length_         = 0;
+    size_t data_complex_length_ = 0;
+    size_t scratch_length_      = 0;
+    /// number of transforms per plan, interleaved
+    size_t batch_    = 1;
+    bool   codelets_ = true;
+
+    BuiltinImpl(const Extent& cextents)
+      : extents_(cextents) {
+      n_ = std::accumulate(extents_.begin(), extents_.end(), static_cast<size_t>(1), std::multiplies<size_t>());
+      n_complex_ = IsComplex ? n_ : n_ / extents_[NDim-1] * (extents_[NDim-1]/2 + 1);
+      batch_ = BuiltinContext::selected().batch;
+      codelets_ = BuiltinContext::selected().codelets;
+
+      data_length_ = (IsComplex || IsInplace ? 2*n_complex_ : n_) * batch_;
+      data_complex_length_ = IsInplace ? 0 : 2*n_complex_*batch_;
+      scratch_length_ = TransformType::scratch_size(std::vector<size_t>(extents_.begin(), extents_.end()),
+                                                    !IsComplex, batch_);
+    }
+
+    /// buffers of the selected batch size without creating the transforms, see FFT::footprint()
+    static FFTFootprint footprint(const Extent& cextents) {
+      const size_t n = std::accumulate(cextents.begin(), cextents.end(), static_cast<size_t>(1), std::multiplies<size_t>());
+      const size_t n_complex = IsComplex ? n : n / cextents[NDim-1] * (cextents[NDim-1]/2 + 1);
+      const size_t batch = BuiltinContext::selected().batch;
+      const size_t data_length = (IsComplex || IsInplace ? 2*n_complex : n) * batch;
+      const size_t data_complex_length = IsInplace ? 0 : 2*n_complex*batch;
+      const size_t scratch_length = TransformType::scratch_size(std::vector<size_t>(cextents.begin(), cextents.end()),
+                                                                !IsComplex, batch);
+      FFTFootprint fp;
+      fp.allocation = (data_length + data_complex_length + scratch_length) * sizeof(RealType);
+      fp.transfer = n*sizeof(value_type);
+      return fp;
+    }
+
+    /// see BuiltinOptions::variants()
+    static std::vector<std::string> variants() {
+      return BuiltinContext::options().variants();
+    }
+
+    static void select_variant(const std::string& variant) {
+      BuiltinContext::select_variant(variant);
+    }
+
+    static std::string variant_group(const std::string& variant) {
+      return BuiltinContext::variant_group(variant);
+    }
+
+    /**
+     * Returns allocated memory for FFT
+     */
+    size_t get_allocation_size() {
+      return (data_length_ + data_complex_length_ + scratch_length_) * sizeof(RealType);
+    }
+
+    /// twiddle tables of forward and inverse transform
+    size_t get_plan_size() {
+      return 2 * create(-1)->get_plan_size();
+    }
+
+    /**
+     * Returns size in bytes of one data transfer.
+     *
+     * Upload and download have the same size due to round-trip FFT.
+     * Transforms of a batch get the same data, the size refers to one transform.
+     * \return Size in bytes of FFT data to be transferred (to device or to host memory buffer).
+     */
+    size_t get_transfer_size() {
+      return n_*sizeof(value_type);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    // --- next methods are benchmarked ---
+
+    void allocate() {
+      data_ = alloc(data_length_);
+      data_complex_ = IsInplace ? data_ : alloc(data_complex_length_);
+      scratch_ = alloc(scratch_length_);
+    }
+
+    void init_forward() {
+      fwd_ = create(-1);
+    }
+
+    void init_inverse() {
+      bwd_ = create(1);
+    }
+
+    void execute_forward() {
+      fwd_->execute(data_, data_complex_, scratch_);
+    }
+
+    void execute_inverse() {
+      bwd_->execute(data_complex_, data_, scratch_);
+    }
+
+    /// copies the input to every transform of the batch
+    template<typename THostData>
+    void upload(THostData* input) {
+      const RealType* host = reinterpret_cast<const RealType*>(input);
+      if(IsComplex) {
+        RealType* re = data_;
+        RealType* im = data_ + n_*batch_;
+        for(size_t i = 0; i < n_; ++i) {
+          for(size_t b = 0; b < batch_; ++b) {
+            re[i*batch_ + b] = host[2*i];
+            im[i*batch_ + b] = host[2*i+1];
+          }
+        }
+      } else if(batch_ == 1) {
+        std::memcpy(data_, host, n_*sizeof(RealType));
+      } else {
+        for(size_t i = 0; i < n_; ++i)
+          std::fill(data_ + i*batch_, data_ + (i+1)*batch_, host[i]);
+      }
+    }
+
+    /// copies the result of the first transform of the batch
+    template<typename THostData>
+    void download(THostData* output) {
+      RealType* host = reinterpret_cast<RealType*>(output);
+      if(IsComplex) {
+        const RealType* re = data_;
+        const RealType* im = data_ + n_*batch_;
+        for(size_t i = 0; i < n_; ++i) {
+          host[2*i] = re[i*batch_];
+          host[2*i+1] = im[i*batch_];
+        }
+      } else if(batch_ == 1) {
+        std::memcpy(host, data_, n_*sizeof(RealType));
+      } else {
+        for(size_t i = 0; i < n_; ++i)
+          host[i] = data_[i*batch_];
+      }
+    }
+
+    void destroy() {
+      if(data_complex_ && !IsInplace)
+        boost::alignment::aligned_free(data_complex_);
+      data_complex_ = nullptr;
+      if(data_)
+        boost::alignment::aligned_free(data_);
+      data_ = nullptr;
+      if(scratch_)
+        boost::alignment::aligned_free(scratch_);
+      scratch_ = nullptr;
+      fwd_.reset();
+      bwd_.reset();
+    }
+
+  private:
+
+    std::unique_ptr<TransformType> create(int sign) const {
+      const std::vector<size_t> extents(extents_.begin(), extents_.end());
+      return std::unique_ptr<TransformType>(new TransformType(extents, !IsComplex, sign, batch_, codelets_));
+    }
+
+    static RealType* alloc(size_t length) {
+      void* p = boost::alignment::aligned_alloc(Alignment, std::max<size_t>(length, 1)*sizeof(RealType));
+      if(!p)
+        throw std::bad_alloc();
+      return static_cast<RealType*>(p);
+    }
+  };
+
+  using Inplace_Real = gearshifft::FFT<FFT_Inplace_Real,
+                                       FFT_Plan_Not_Reusable,
+                                       BuiltinImpl,
+                                       TimerCPU>;
+
+  using Outplace_Real = gearshifft::FFT<FFT_Outplace_Real,
+                                        FFT_Plan_Not_Reusable,
+                                        BuiltinImpl,
+                                        TimerCPU>;
+
+  using Inplace_Complex = gearshifft::FFT<FFT_Inplace_Complex,
+                                          FFT_Plan_Not_Reusable,
+                                          BuiltinImpl,
+                                          TimerCPU>;
+
+  using Outplace_Complex = gearshifft::FFT<FFT_Outplace_Complex,
+                                           FFT_Plan_Not_Reusable,
+                                           BuiltinImpl,
+                                           TimerCPU>;
+
+} // namespace builtin
+} // namespace gearshifft
+
+#endif /* BUILTIN_HPP_ */
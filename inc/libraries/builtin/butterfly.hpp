@@ -0,0 +1,128 @@
+#ifndef BUTTERFLY_HPP_
+#define BUTTERFLY_HPP_
+
+#include <cmath>
+#include <cstddef>
+
+namespace gearshifft {
+namespace builtin {
+
+  /// exp(sign*2*pi*i*k/n), computed in extended precision
+  template<typename T>
+  void root(int sign, size_t k, size_t n, T& re, T& im) {
+    const long double pi = 3.141592653589793238462643383279502884L;
+    const long double phi = 2.0L * pi * static_cast<long double>(k % n) / static_cast<long double>(n);
+    re = static_cast<T>(std::cos(phi));
+    im = static_cast<T>(sign * std::sin(phi));
+  }
+
+  /**
+   * Butterflies of small radices on local arrays, s = +-1 is the sign of the
+   * exponent. Inlined into the vectorized loops of Stockham::pass().
+   */
+  template<typename T, size_t R>
+  struct Butterfly;
+
+  template<typename T>
+  struct Butterfly<T, 2> {
+    static void apply(T* vr, T* vi, T) {
+      const T r = vr[0] - vr[1];
+      const T i = vi[0] - vi[1];
+      vr[0] += vr[1];
+      vi[0] += vi[1];
+      vr[1] = r;
+      vi[1] = i;
+    }
+  };
+
+  template<typename T>
+  struct Butterfly<T, 3> {
+    static void apply(T* vr, T* vi, T s) {
+      const T h = static_cast<T>(0.86602540378443864676L) * s; // sin(2pi/3)
+      const T ar = vr[1] + vr[2];
+      const T ai = vi[1] + vi[2];
+      const T br = vr[0] - static_cast<T>(0.5) * ar;
+      const T bi = vi[0] - static_cast<T>(0.5) * ai;
+      const T dr = -h * (vi[1] - vi[2]);
+      const T di = h * (vr[1] - vr[2]);
+      vr[0] += ar;
+      vi[0] += ai;
+      vr[1] = br + dr;
+      vi[1] = bi + di;
+      vr[2] = br - dr;
+      vi[2] = bi - di;
+    }
+  };
+
+  template<typename T>
+  struct Butterfly<T, 4> {
+    static void apply(T* vr, T* vi, T s) {
+      const T a0r = vr[0] + vr[2], a0i = vi[0] + vi[2];
+      const T a1r = vr[0] - vr[2], a1i = vi[0] - vi[2];
+      const T a2r = vr[1] + vr[3], a2i = vi[1] + vi[3];
+      // (v1-v3)*s*i
+      const T a3r = -s * (vi[1] - vi[3]), a3i = s * (vr[1] - vr[3]);
+      vr[0] = a0r + a2r; vi[0] = a0i + a2i;
+      vr[1] = a1r + a3r; vi[1] = a1i + a3i;
+      vr[2] = a0r - a2r; vi[2] = a0i - a2i;
+      vr[3] = a1r - a3r; vi[3] = a1i - a3i;
+    }
+  };
+
+  template<typename T>
+  struct Butterfly<T, 5> {
+    static void apply(T* vr, T* vi, T s) {
+      const T c1 = static_cast<T>(0.30901699437494742410L);  // cos(2pi/5)
+      const T c2 = static_cast<T>(-0.80901699437494742410L); // cos(4pi/5)
+      const T s1 = static_cast<T>(0.95105651629515357212L) * s; // sin(2pi/5)
+      const T s2 = static_cast<T>(0.58778525229247312917L) * s; // sin(4pi/5)
+      const T a1r = vr[1] + vr[4], a1i = vi[1] + vi[4];
+      const T b1r = vr[1] - vr[4], b1i = vi[1] - vi[4];
+      const T a2r = vr[2] + vr[3], a2i = vi[2] + vi[3];
+      const T b2r = vr[2] - vr[3], b2i = vi[2] - vi[3];
+      const T p1r = vr[0] + c1*a1r + c2*a2r, p1i = vi[0] + c1*a1i + c2*a2i;
+      const T p2r = vr[0] + c2*a1r + c1*a2r, p2i = vi[0] + c2*a1i + c1*a2i;
+      // i*(s1*b1 + s2*b2) and i*(s2*b1 - s1*b2)
+      const T q1r = -(s1*b1i + s2*b2i), q1i = s1*b1r + s2*b2r;
+      const T q2r = -(s2*b1i - s1*b2i), q2i = s2*b1r - s1*b2r;
+      vr[0] += a1r + a2r; vi[0] += a1i + a2i;
+      vr[1] = p1r + q1r; vi[1] = p1i + q1i;
+      vr[4] = p1r - q1r; vi[4] = p1i - q1i;
+      vr[2] = p2r + q2r; vi[2] = p2i + q2i;
+      vr[3] = p2r - q2r; vi[3] = p2i - q2i;
+    }
+  };
+
+  template<typename T>
+  struct Butterfly<T, 8> {
+    static void apply(T* vr, T* vi, T s) {
+      const T c = static_cast<T>(0.70710678118654752440L);
+      T er[4] = {vr[0], vr[2], vr[4], vr[6]};
+      T ei[4] = {vi[0], vi[2], vi[4], vi[6]};
+      T or_[4] = {vr[1], vr[3], vr[5], vr[7]};
+      T oi[4] = {vi[1], vi[3], vi[5], vi[7]};
+      Butterfly<T, 4>::apply(er, ei, s);
+      Butterfly<T, 4>::apply(or_, oi, s);
+      // odd part times w8^k, w8 = c*(1+s*i)
+      T t = or_[1];
+      or_[1] = c * (t - s*oi[1]);
+      oi[1] = c * (oi[1] + s*t);
+      t = or_[2];
+      or_[2] = -s * oi[2];
+      oi[2] = s * t;
+      t = or_[3];
+      or_[3] = c * (-t - s*oi[3]);
+      oi[3] = c * (-oi[3] + s*t);
+      for(size_t k = 0; k < 4; ++k) {
+        vr[k] = er[k] + or_[k];
+        vi[k] = ei[k] + oi[k];
+        vr[k+4] = er[k] - or_[k];
+        vi[k+4] = ei[k] - oi[k];
+      }
+    }
+  };
+
+} // namespace builtin
+} // namespace gearshifft
+
+#endif /* BUTTERFLY_HPP_ */
@@ -0,0 +1,235 @@
+#ifndef CODELET_HPP_
+#define CODELET_HPP_
+
+#include "butterfly.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+namespace gearshifft {
+namespace builtin {
+
+  /**
+   * Fixed-size FFT kernels (codelets) generated at compile time for small
+   * sizes with factors 2, 3 and 5. A codelet is a decimation-in-time FFT
+   * unrolled by template recursion, its twiddles are compile-time constants.
+   */
+  namespace codelet {
+
+    constexpr long double Pi = 3.141592653589793238462643383279502884L;
+
+    /// sin(x) and cos(x) by Taylor series, |x| <= pi
+    constexpr long double sin_taylor(long double x) {
+      long double term = x;
+      long double sum = x;
+      for(int k = 1; k < 30; ++k) {
+        term *= -x*x / static_cast<long double>((2*k)*(2*k+1));
+        sum += term;
+      }
+      return sum;
+    }
+
+    constexpr long double cos_taylor(long double x) {
+      long double term = 1.0L;
+      long double sum = 1.0L;
+      for(int k = 1; k < 30; ++k) {
+        term *= -x*x / static_cast<long double>((2*k-1)*(2*k));
+        sum += term;
+      }
+      return sum;
+    }
+
+    /// angle 2*pi*k/n reduced to [-pi, pi]
+    constexpr long double angle(size_t k, size_t n) {
+      k %= n;
+      return 2 * k > n ? -2.0L * Pi * static_cast<long double>(n-k) / static_cast<long double>(n)
+                       : 2.0L * Pi * static_cast<long double>(k) / static_cast<long double>(n);
+    }
+
+    template<typename T, size_t N>
+    struct Table {
+      T re[N];
+      T im[N];
+    };
+
+    /// exp(Sign*2*pi*i*k/N), k < N
+    template<typename T, size_t N, int Sign>
+    constexpr Table<T, N> make_roots() {
+      Table<T, N> table{};
+      for(size_t k = 0; k < N; ++k) {
+        table.re[k] = static_cast<T>(cos_taylor(angle(k, N)));
+        table.im[k] = static_cast<T>(Sign * sin_taylor(angle(k, N)));
+      }
+      return table;
+    }
+
+    template<typename T, size_t N, int Sign>
+    struct Roots {
+      static constexpr Table<T, N> value = make_roots<T, N, Sign>();
+    };
+
+    template<typename T, size_t N, int Sign>
+    constexpr Table<T, N> Roots<T, N, Sign>::value;
+
+    /// radix of the last stage: 8 or 4 if possible, then 2, 3 and 5
+    constexpr size_t radix(size_t n) {
+      return n % 8 == 0 ? 8 : n % 4 == 0 ? 4 : n % 2 == 0 ? 2 : n % 3 == 0 ? 3 : 5;
+    }
+
+    /// vector lanes of a codelet, transforms computed together (64 bytes of T)
+    template<typename T>
+    constexpr size_t lanes() {
+      return 64 / sizeof(T);
+    }
+
+    /**
+     * In-place FFT of size N of W transforms on split arrays in natural order,
+     * element i of transform w is at i*W + w. N/R subtransforms of the R
+     * decimated sequences, then N/R twiddled radix-R butterflies. The loops
+     * over the W transforms are vectorized.
+     */
+    template<typename T, size_t N, int Sign, size_t W>
+    struct Codelet {
+      static constexpr size_t R = radix(N);
+      static constexpr size_t M = N / R;
+      static_assert(M * R == N, "codelet sizes must only have factors 2, 3 and 5");
+
+      static void apply(T* xr, T* xi) {
+        alignas(64) T sr[N*W];
+        alignas(64) T si[N*W];
+        for(size_t r = 0; r < R; ++r) {
+          for(size_t m = 0; m < M; ++m) {
+            const T* ar = xr + (r + R*m)*W;
+            const T* ai = xi + (r + R*m)*W;
+            T* br = sr + (r*M + m)*W;
+            T* bi = si + (r*M + m)*W;
+#pragma omp simd
+            for(size_t w = 0; w < W; ++w) {
+              br[w] = ar[w];
+              bi[w] = ai[w];
+            }
+          }
+          Codelet<T, M, Sign, W>::apply(sr + r*M*W, si + r*M*W);
+        }
+        using Roots_N = Roots<T, N, Sign>;
+        for(size_t k = 0; k < M; ++k) {
+#pragma omp simd
+          for(size_t w = 0; w < W; ++w) {
+            T vr[R];
+            T vi[R];
+            for(size_t r = 0; r < R; ++r) {
+              const size_t q = (r*k) % N;
+              const T ar = sr[(r*M + k)*W + w];
+              const T ai = si[(r*M + k)*W + w];
+              if(q == 0) {
+                vr[r] = ar;
+                vi[r] = ai;
+              } else {
+                vr[r] = ar*Roots_N::value.re[q] - ai*Roots_N::value.im[q];
+                vi[r] = ar*Roots_N::value.im[q] + ai*Roots_N::value.re[q];
+              }
+            }
+            Butterfly<T, R>::apply(vr, vi, static_cast<T>(Sign));
+            for(size_t q = 0; q < R; ++q) {
+              xr[(k + M*q)*W + w] = vr[q];
+              xi[(k + M*q)*W + w] = vi[q];
+            }
+          }
+        }
+      }
+    };
+
+    template<typename T, int Sign, size_t W>
+    struct Codelet<T, 1, Sign, W> {
+      static void apply(T*, T*) {
+      }
+    };
+
+    /**
+     * Transforms outer*stride sequences of size N, element i of sequence (o, c)
+     * is at (o*N + i)*stride + c (as Stockham::execute()), source and destination
+     * may be the same arrays. Blocks of W sequences (contiguous sequences c,
+     * or o for stride 1) are copied to a local buffer and transformed together.
+     */
+    template<typename T, size_t N, int Sign>
+    void batch(const T* xr, const T* xi, T* yr, T* yi, size_t outer, size_t stride) {
+      constexpr size_t W = lanes<T>();
+      alignas(64) T br[N*W];
+      alignas(64) T bi[N*W];
+      // sequences s0..s0+W-1, a partial block repeats its last sequence
+      const size_t count = outer*stride;
+      const size_t step = stride == 1 ? 1 : stride;
+      for(size_t s0 = 0; s0 < count; s0 += W) {
+        const size_t used = std::min(W, count - s0);
+        size_t first[W];
+        for(size_t w = 0; w < W; ++w) {
+          const size_t s = s0 + std::min(w, used-1);
+          first[w] = stride == 1 ? s*N : (s/stride)*N*stride + s%stride;
+        }
+        // W neighbouring sequences of the same o are contiguous
+        const bool contiguous = stride > 1 && used == W && s0%stride + W <= stride;
+        for(size_t i = 0; i < N; ++i) {
+          if(contiguous) {
+            const T* ar = xr + first[0] + i*step;
+            const T* ai = xi + first[0] + i*step;
+#pragma omp simd
+            for(size_t w = 0; w < W; ++w) {
+              br[i*W + w] = ar[w];
+              bi[i*W + w] = ai[w];
+            }
+          } else {
+            for(size_t w = 0; w < W; ++w) {
+              br[i*W + w] = xr[first[w] + i*step];
+              bi[i*W + w] = xi[first[w] + i*step];
+            }
+          }
+        }
+        Codelet<T, N, Sign, W>::apply(br, bi);
+        for(size_t i = 0; i < N; ++i) {
+          if(contiguous) {
+            T* ar = yr + first[0] + i*step;
+            T* ai = yi + first[0] + i*step;
+#pragma omp simd
+            for(size_t w = 0; w < W; ++w) {
+              ar[w] = br[i*W + w];
+              ai[w] = bi[i*W + w];
+            }
+          } else {
+            for(size_t w = 0; w < used; ++w) {
+              yr[first[w] + i*step] = br[i*W + w];
+              yi[first[w] + i*step] = bi[i*W + w];
+            }
+          }
+        }
+      }
+    }
+
+    template<typename T>
+    using Kernel = void (*)(const T*, const T*, T*, T*, size_t, size_t);
+
+    /// sizes with a codelet, all sizes up to 64 with factors 2, 3 and 5
+    using Sizes = std::index_sequence<2, 3, 4, 5, 6, 8, 9, 10, 12, 15, 16, 18, 20, 24, 25,
+                                      27, 30, 32, 36, 40, 45, 48, 50, 54, 60, 64>;
+
+    template<typename T, int Sign, size_t... Ns>
+    Kernel<T> find(size_t n, std::index_sequence<Ns...>) {
+      static const size_t sizes[] = {Ns...};
+      static const Kernel<T> kernels[] = {&batch<T, Ns, Sign>...};
+      for(size_t k = 0; k < sizeof...(Ns); ++k)
+        if(sizes[k] == n)
+          return kernels[k];
+      return nullptr;
+    }
+
+    /// codelet of size n and exponent sign, nullptr if there is none
+    template<typename T>
+    Kernel<T> find(size_t n, int sign) {
+      return sign < 0 ? find<T, -1>(n, Sizes()) : find<T, 1>(n, Sizes());
+    }
+
+  } // namespace codelet
+} // namespace builtin
+} // namespace gearshifft
+
+#endif /* CODELET_HPP_ */
@@ -0,0 +1,518 @@
+#ifndef STOCKHAM_HPP_
+#define STOCKHAM_HPP_
+
+#include "codelet.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+namespace gearshifft {
+namespace builtin {
+
+  /**
+   * Radices of n for the Stockham passes, 8 and 4 first, then 2, 5, 3
+   * and remaining prime factors (generic butterfly).
+   */
+  inline std::vector<size_t> factorize(size_t n) {
+    std::vector<size_t> radices;
+    if(n == 0)
+      throw std::runtime_error("Invalid transform size 0.");
+    for(size_t r : {8, 4, 2, 5, 3}) {
+      while(n % r == 0) {
+        radices.push_back(r);
+        n /= r;
+      }
+    }
+    for(size_t p = 7; p*p <= n; p += 2) {
+      while(n % p == 0) {
+        radices.push_back(p);
+        n /= p;
+      }
+    }
+    if(n > 1)
+      radices.push_back(n);
+    return radices;
+  }
+
+  /**
+   * Plan of 1D complex transforms of length n by the self-sorting (auto-sort)
+   * Stockham algorithm, mixed radices 8, 4, 2, 5, 3 and generic prime radices.
+   *
+   * Data is split complex (real and imaginary arrays). Sequences are batched:
+   * element i of sequence (o, c) is at (o*n + i)*stride + c. The innermost loop
+   * of a pass runs over contiguous elements (the sequences for stride > 1,
+   * the butterflies of a block for stride 1) and is vectorized by the compiler
+   * (OpenMP simd). Transforms are unnormalized.
+   * Sizes with a codelet (see codelet.hpp) are computed by the codelet
+   * unless codelets are disabled.
+   */
+  template<typename T>
+  class Stockham {
+  public:
+    Stockham(size_t n, int sign, bool codelets = true)
+      : n_(n), sign_(sign), kernel_(codelets ? codelet::find<T>(n, sign) : nullptr) {
+      if(kernel_)
+        return;
+      size_t ns = 1;
+      for(size_t radix : factorize(n)) {
+        Stage stage;
+        stage.radix = radix;
+        stage.ns = ns;
+        // twiddles w^(r*t) of the stage, w = exp(sign*2*pi*i/(ns*radix))
+        stage.wr.resize((radix-1)*ns);
+        stage.wi.resize((radix-1)*ns);
+        for(size_t r = 1; r < radix; ++r)
+          for(size_t t = 0; t < ns; ++t)
+            root(sign, r*t, ns*radix, stage.wr[(r-1)*ns+t], stage.wi[(r-1)*ns+t]);
+        if(!is_special(radix)) {
+          stage.rr.resize(radix);
+          stage.ri.resize(radix);
+          for(size_t k = 0; k < radix; ++k)
+            root(sign, k, radix, stage.rr[k], stage.ri[k]);
+        }
+        stages_.push_back(stage);
+        ns *= radix;
+      }
+    }
+
+    size_t size() const {
+      return n_;
+    }
+
+    /// bytes of the twiddle tables
+    size_t get_plan_size() const {
+      size_t bytes = 0;
+      for(const auto& stage : stages_)
+        bytes += (stage.wr.size() + stage.wi.size() + stage.rr.size() + stage.ri.size()) * sizeof(T);
+      return bytes;
+    }
+
+    /**
+     * Transforms outer*stride sequences from source to destination (may be
+     * the same arrays), the work arrays have the same size.
+     */
+    void execute(const T* sr, const T* si, T* dr, T* di,
+                 T* wr, T* wi, size_t outer, size_t stride) const {
+      if(kernel_) {
+        kernel_(sr, si, dr, di, outer, stride);
+        return;
+      }
+      const size_t len = outer*n_*stride;
+      if(stages_.empty()) {
+        if(sr != dr) {
+          std::copy(sr, sr+len, dr);
+          std::copy(si, si+len, di);
+        }
+        return;
+      }
+      // passes alternate between destination and work arrays and end in the destination
+      bool to_dst = stages_.size() % 2 == 1;
+      const T* xr = sr;
+      const T* xi = si;
+      if(sr == dr && to_dst) {
+        std::copy(sr, sr+len, wr);
+        std::copy(si, si+len, wi);
+        xr = wr;
+        xi = wi;
+      }
+      for(const auto& stage : stages_) {
+        T* yr = to_dst ? dr : wr;
+        T* yi = to_dst ? di : wi;
+        pass(stage, xr, xi, yr, yi, outer, stride);
+        xr = yr;
+        xi = yi;
+        to_dst = !to_dst;
+      }
+    }
+
+  private:
+    struct Stage {
+      size_t radix = 0;
+      /// product of the radices of the previous stages
+      size_t ns = 1;
+      std::vector<T> wr;
+      std::vector<T> wi;
+      /// roots of unity of generic radices
+      std::vector<T> rr;
+      std::vector<T> ri;
+    };
+
+    size_t n_;
+    int sign_;
+    /// codelet of size n, replaces the passes
+    codelet::Kernel<T> kernel_;
+    std::vector<Stage> stages_;
+
+    static bool is_special(size_t radix) {
+      return radix == 2 || radix == 3 || radix == 4 || radix == 5 || radix == 8;
+    }
+
+    /**
+     * One radix-R pass: y[(b*ns*R + r*ns + t)] = DFT_R(w^(r*t) * x[b*ns + t + r*n/R])
+     * for the blocks b and t < ns.
+     */
+    void pass(const Stage& stage, const T* xr, const T* xi, T* yr, T* yi,
+              size_t outer, size_t stride) const {
+      switch(stage.radix) {
+      case 2: pass<2>(stage, xr, xi, yr, yi, outer, stride); break;
+      case 3: pass<3>(stage, xr, xi, yr, yi, outer, stride); break;
+      case 4: pass<4>(stage, xr, xi, yr, yi, outer, stride); break;
+      case 5: pass<5>(stage, xr, xi, yr, yi, outer, stride); break;
+      case 8: pass<8>(stage, xr, xi, yr, yi, outer, stride); break;
+      default: pass_generic(stage, xr, xi, yr, yi, outer, stride);
+      }
+    }
+
+    template<size_t R>
+    void pass(const Stage& stage, const T* xr, const T* xi, T* yr, T* yi,
+              size_t outer, size_t stride) const {
+      const size_t ns = stage.ns;
+      const size_t m = n_/R;
+      const size_t blocks = m/ns;
+      const T s = static_cast<T>(sign_);
+      const T* twr = stage.wr.data();
+      const T* twi = stage.wi.data();
+      for(size_t o = 0; o < outer; ++o) {
+        for(size_t b = 0; b < blocks; ++b) {
+          const size_t in = (o*n_ + b*ns) * stride;
+          const size_t out = (o*n_ + b*ns*R) * stride;
+          if(stride == 1) {
+            // butterflies of the block are contiguous, twiddles vary
+#pragma omp simd
+            for(size_t t = 0; t < ns; ++t) {
+              T vr[R], vi[R];
+              vr[0] = xr[in+t];
+              vi[0] = xi[in+t];
+              for(size_t r = 1; r < R; ++r) {
+                const T ar = xr[in+r*m+t];
+                const T ai = xi[in+r*m+t];
+                const T cr = twr[(r-1)*ns+t];
+                const T ci = twi[(r-1)*ns+t];
+                vr[r] = ar*cr - ai*ci;
+                vi[r] = ar*ci + ai*cr;
+              }
+              Butterfly<T, R>::apply(vr, vi, s);
+              for(size_t r = 0; r < R; ++r) {
+                yr[out+r*ns+t] = vr[r];
+                yi[out+r*ns+t] = vi[r];
+              }
+            }
+          } else {
+            // sequences are contiguous, twiddles are constant
+            for(size_t t = 0; t < ns; ++t) {
+              T cr[R], ci[R];
+              for(size_t r = 1; r < R; ++r) {
+                cr[r] = twr[(r-1)*ns+t];
+                ci[r] = twi[(r-1)*ns+t];
+              }
+              const T* ir = xr + in + t*stride;
+              const T* ii = xi + in + t*stride;
+              T* orr = yr + out + t*stride;
+              T* oi = yi + out + t*stride;
+#pragma omp simd
+              for(size_t c = 0; c < stride; ++c) {
+                T vr[R], vi[R];
+                vr[0] = ir[c];
+                vi[0] = ii[c];
+                for(size_t r = 1; r < R; ++r) {
+                  const T ar = ir[r*m*stride+c];
+                  const T ai = ii[r*m*stride+c];
+                  vr[r] = ar*cr[r] - ai*ci[r];
+                  vi[r] = ar*ci[r] + ai*cr[r];
+                }
+                Butterfly<T, R>::apply(vr, vi, s);
+                for(size_t r = 0; r < R; ++r) {
+                  orr[r*ns*stride+c] = vr[r];
+                  oi[r*ns*stride+c] = vi[r];
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+
+    /// pass of a prime radix by a direct DFT of each butterfly
+    void pass_generic(const Stage& stage, const T* xr, const T* xi, T* yr, T* yi,
+                      size_t outer, size_t stride) const {
+      const size_t R = stage.radix;
+      const size_t ns = stage.ns;
+      const size_t m = n_/R;
+      const size_t blocks = m/ns;
+      std::vector<T> vr(R), vi(R);
+      for(size_t o = 0; o < outer; ++o) {
+        for(size_t b = 0; b < blocks; ++b) {
+          for(size_t t = 0; t < ns; ++t) {
+            const size_t in = (o*n_ + b*ns + t) * stride;
+            const size_t out = (o*n_ + b*ns*R + t) * stride;
+            for(size_t c = 0; c < stride; ++c) {
+              for(size_t r = 0; r < R; ++r) {
+                const T ar = xr[in+r*m*stride+c];
+                const T ai = xi[in+r*m*stride+c];
+                const T cr = r ? stage.wr[(r-1)*ns+t] : static_cast<T>(1);
+                const T ci = r ? stage.wi[(r-1)*ns+t] : static_cast<T>(0);
+                vr[r] = ar*cr - ai*ci;
+                vi[r] = ar*ci + ai*cr;
+              }
+              for(size_t k = 0; k < R; ++k) {
+                T sr = 0;
+                T si = 0;
+                for(size_t r = 0; r < R; ++r) {
+                  const size_t q = (r*k) % R;
+                  sr += vr[r]*stage.rr[q] - vi[r]*stage.ri[q];
+                  si += vr[r]*stage.ri[q] + vi[r]*stage.rr[q];
+                }
+                yr[out+k*ns*stride+c] = sr;
+                yi[out+k*ns*stride+c] = si;
+              }
+            }
+          }
+        }
+      }
+    }
+  };
+
+  /**
+   * Multi-dimensional complex (C2C) or real (R2C forward, C2R inverse) transform
+   * of row-major extents by Stockham passes along each dimension.
+   *
+   * Complex arrays are split: all real parts followed by all imaginary parts.
+   * Real arrays are dense. Real transforms of even length along the last
+   * dimension use a complex transform of half length and a post-processing
+   * (pre-processing for C2R) step, odd lengths a full complex transform.
+   * C2R transforms overwrite their input.
+   *
+   * A batch of transforms is interleaved (structure of arrays): element i of
+   * transform b is at i*batch + b, so the passes and codelets run over
+   * the transforms of the batch in their vectorized loops.
+   */
+  template<typename T>
+  class Transform {
+  public:
+    Transform(const std::vector<size_t>& extents, bool real, int sign,
+              size_t batch = 1, bool codelets = true)
+      : extents_(extents), real_(real), sign_(sign), batch_(batch) {
+      if(batch_ == 0)
+        throw std::runtime_error("Invalid batch size 0.");
+      const size_t ndim = extents_.size();
+      cextents_ = extents_;
+      if(real_)
+        cextents_.back() = extents_.back()/2 + 1;
+      n_ = product(extents_, 0, ndim) * batch_;
+      n_complex_ = product(cextents_, 0, ndim) * batch_;
+      const size_t complex_dims = real_ ? ndim-1 : ndim;
+      for(size_t d = 0; d < complex_dims; ++d)
+        passes_.emplace_back(cextents_[d], sign_, codelets);
+      if(real_) {
+        const size_t len = extents_.back();
+        const size_t half = len % 2 == 0 ? len/2 : len;
+        passes_.emplace_back(half, sign_, codelets);
+        // twiddles exp(sign*2*pi*i*k/len) of the real post-/pre-processing
+        if(len % 2 == 0) {
+          pr_.resize(half+1);
+          pi_.resize(half+1);
+          for(size_t k = 0; k <= half; ++k)
+            root(sign_, k, len, pr_[k], pi_[k]);
+        }
+      }
+    }
+
+    /// elements of T of the work buffer
+    size_t scratch_size() const {
+      return scratch_size(extents_, real_, batch_);
+    }
+
+    /// elements of T of the work buffer of a transform, without creating it
+    static size_t scratch_size(const std::vector<size_t>& extents, bool real, size_t batch) {
+      const size_t ndim = extents.size();
+      std::vector<size_t> cextents = extents;
+      if(real)
+        cextents.back() = extents.back()/2 + 1;
+      const size_t n_complex = product(cextents, 0, ndim) * batch;
+      if(!real)
+        return 2*n_complex;
+      const size_t len = extents.back();
+      const size_t rows = product(extents, 0, ndim) * batch / len;
+      const size_t half = len % 2 == 0 ? len/2 : len;
+      return std::max(2*n_complex, 4*rows*half);
+    }
+
+    /// bytes of the twiddle tables
+    size_t get_plan_size() const {
+      size_t bytes = (pr_.size() + pi_.size()) * sizeof(T);
+      for(const auto& pass : passes_)
+        bytes += pass.get_plan_size();
+      return bytes;
+    }
+
+    /**
+     * Executes the transform, input and output may be the same buffer.
+     * C2C and C2R take split complex input, R2C and C2R real input or output.
+     */
+    void execute(T* in, T* out, T* scratch) const {
+      const size_t ndim = extents_.size();
+      if(!real_) {
+        for(size_t d = 0; d < ndim; ++d) {
+          const T* src = d == 0 ? in : out;
+          passes_[d].execute(src, src+n_complex_, out, out+n_complex_,
+                             scratch, scratch+n_complex_,
+                             product(cextents_, 0, d), product(cextents_, d+1, ndim)*batch_);
+        }
+      } else if(sign_ < 0) {
+        last_r2c(in, out, scratch);
+        for(size_t d = 0; d+1 < ndim; ++d)
+          passes_[d].execute(out, out+n_complex_, out, out+n_complex_,
+                             scratch, scratch+n_complex_,
+                             product(cextents_, 0, d), product(cextents_, d+1, ndim)*batch_);
+      } else {
+        for(size_t d = 0; d+1 < ndim; ++d)
+          passes_[d].execute(in, in+n_complex_, in, in+n_complex_,
+                             scratch, scratch+n_complex_,
+                             product(cextents_, 0, d), product(cextents_, d+1, ndim)*batch_);
+        last_c2r(in, out, scratch);
+      }
+    }
+
+  private:
+    std::vector<size_t> extents_;
+    std::vector<size_t> cextents_;
+    bool real_;
+    int sign_;
+    size_t batch_;
+    /// number of elements of all transforms of the batch
+    size_t n_ = 0;
+    size_t n_complex_ = 0;
+    /// complex passes of the dimensions, last one of real transforms along the rows
+    std::vector<Stockham<T> > passes_;
+    /// twiddles of the real post-/pre-processing
+    std::vector<T> pr_;
+    std::vector<T> pi_;
+
+    static size_t product(const std::vector<size_t>& e, size_t first, size_t last) {
+      return std::accumulate(e.begin()+static_cast<std::ptrdiff_t>(first),
+                             e.begin()+static_cast<std::ptrdiff_t>(last),
+                             static_cast<size_t>(1), std::multiplies<size_t>());
+    }
+
+    /// real rows to split complex rows of length len/2+1
+    void last_r2c(const T* in, T* out, T* scratch) const {
+      const size_t len = extents_.back();
+      const size_t rows = n_ / len / batch_;
+      const size_t clen = cextents_.back();
+      const size_t half = passes_.back().size();
+      const size_t nb = batch_;
+      const size_t zn = rows*half*nb;
+      T* zr = scratch;
+      T* zi = scratch + zn;
+      T* wr = scratch + 2*zn;
+      T* wi = scratch + 3*zn;
+      if(len % 2 == 0) {
+        // z = even + i*odd samples
+        for(size_t j = 0; j < rows*half; ++j) {
+          for(size_t b = 0; b < nb; ++b) {
+            zr[j*nb+b] = in[2*j*nb+b];
+            zi[j*nb+b] = in[(2*j+1)*nb+b];
+          }
+        }
+      } else {
+        std::copy(in, in+n_, zr);
+        std::fill(zi, zi+zn, static_cast<T>(0));
+      }
+      passes_.back().execute(zr, zi, zr, zi, wr, wi, rows, nb);
+      T* xr = out;
+      T* xi = out + n_complex_;
+      for(size_t row = 0; row < rows; ++row) {
+        const T* ar = zr + row*half*nb;
+        const T* ai = zi + row*half*nb;
+        T* br = xr + row*clen*nb;
+        T* bi = xi + row*clen*nb;
+        if(len % 2 == 1) {
+          std::copy(ar, ar+clen*nb, br);
+          std::copy(ai, ai+clen*nb, bi);
+          continue;
+        }
+        // X[k] = E[k] + w^k*O[k], E = (Z[k]+conj(Z[h-k]))/2, O = (Z[k]-conj(Z[h-k]))/(2i)
+        for(size_t k = 0; k <= half; ++k) {
+          const size_t p = (k % half)*nb;
+          const size_t q = ((half-k) % half)*nb;
+          for(size_t b = 0; b < nb; ++b) {
+            const T pr = ar[p+b], pi = ai[p+b];
+            const T qr = ar[q+b], qi = -ai[q+b];
+            const T er = static_cast<T>(0.5)*(pr + qr);
+            const T ei = static_cast<T>(0.5)*(pi + qi);
+            const T or_ = static_cast<T>(0.5)*(pi - qi);
+            const T oi = static_cast<T>(-0.5)*(pr - qr);
+            br[k*nb+b] = er + pr_[k]*or_ - pi_[k]*oi;
+            bi[k*nb+b] = ei + pr_[k]*oi + pi_[k]*or_;
+          }
+        }
+      }
+    }
+
+    /// split complex rows of length len/2+1 to real rows
+    void last_c2r(const T* in, T* out, T* scratch) const {
+      const size_t len = extents_.back();
+      const size_t rows = n_ / len / batch_;
+      const size_t clen = cextents_.back();
+      const size_t half = passes_.back().size();
+      const size_t nb = batch_;
+      const size_t zn = rows*half*nb;
+      T* zr = scratch;
+      T* zi = scratch + zn;
+      T* wr = scratch + 2*zn;
+      T* wi = scratch + 3*zn;
+      const T* xr = in;
+      const T* xi = in + n_complex_;
+      for(size_t row = 0; row < rows; ++row) {
+        const T* ar = xr + row*clen*nb;
+        const T* ai = xi + row*clen*nb;
+        T* br = zr + row*half*nb;
+        T* bi = zi + row*half*nb;
+        if(len % 2 == 1) {
+          // hermitian extension
+          std::copy(ar, ar+clen*nb, br);
+          std::copy(ai, ai+clen*nb, bi);
+          for(size_t k = clen; k < len; ++k) {
+            for(size_t b = 0; b < nb; ++b) {
+              br[k*nb+b] = ar[(len-k)*nb+b];
+              bi[k*nb+b] = -ai[(len-k)*nb+b];
+            }
+          }
+          continue;
+        }
+        // Z[k] = (X[k]+conj(X[h-k])) + i*w^k*(X[k]-conj(X[h-k]))
+        for(size_t k = 0; k < half; ++k) {
+          for(size_t b = 0; b < nb; ++b) {
+            const T pr = ar[k*nb+b], pi = ai[k*nb+b];
+            const T qr = ar[(half-k)*nb+b], qi = -ai[(half-k)*nb+b];
+            const T sr = pr + qr, si = pi + qi;
+            const T dr = pr - qr, di = pi - qi;
+            const T tr = pr_[k]*dr - pi_[k]*di;
+            const T ti = pr_[k]*di + pi_[k]*dr;
+            br[k*nb+b] = sr - ti;
+            bi[k*nb+b] = si + tr;
+          }
+        }
+      }
+      passes_.back().execute(zr, zi, zr, zi, wr, wi, rows, nb);
+      if(len % 2 == 0) {
+        for(size_t j = 0; j < rows*half; ++j) {
+          for(size_t b = 0; b < nb; ++b) {
+            out[2*j*nb+b] = zr[j*nb+b];
+            out[(2*j+1)*nb+b] = zi[j*nb+b];
+          }
+        }
+      } else {
+        std::copy(zr, zr+n_, out);
+      }
+    }
+  };
+
+} // namespace builtin
+} // namespace gearshifft
+
+#endif /* STOCKHAM_HPP_ */
@@ -295,6 +295,11 @@ namespace gearshifft
         destroy();
       }
 
+      /// buffer sizes without creating a plan or a device context, see FFT::footprint()
+      static FFTFootprint footprint(const Extent& cextents) {
+        return dense_footprint<IsComplex, IsInplace>(cextents, sizeof(RealType));
+      }
+
       /**
        * Returns size in bytes of one data transfer.
        *
@@ -346,6 +346,11 @@ namespace CuFFT {
       destroy();
     }
 
+    /// buffer sizes without creating a plan or a device context, see FFT::footprint()
+    static FFTFootprint footprint(const Extent& cextents) {
+      return dense_footprint<IsComplex, IsInplace>(cextents, sizeof(RealType));
+    }
+
     /**
      * Returns allocated memory on device for FFT
      */
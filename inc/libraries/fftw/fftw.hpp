@@ -9,11 +9,16 @@
 #include "core/fft.hpp"
 #include "core/benchmark_suite.hpp"
 #include "core/get_memory_size.hpp"
+#include "core/parallel.hpp"
 #include "core/unused.hpp"
+#include "fftw_wisdom.hpp"
 
 #include <algorithm>
 #include <array>
+#include <cctype>
+#include <cstddef>
 #include <cstring>
+#include <limits>
 #include <sstream>
 #include <thread>
 #include <type_traits>
@@ -48,24 +53,239 @@ namespace fftw {
 
     FftwOptions() : OptionsDefault() {
       add_options()
-        ("rigor", value(&rigor_)->default_value("measure"), "FFTW rigor (measure, estimate, wisdom, patient or exhaustive)")
+        ("rigor", value(&rigor_)->default_value("measure"), "FFTW rigor (measure, estimate, wisdom, patient or exhaustive). A comma-separated list (e.g. estimate,measure,patient) or all (estimate to exhaustive) runs every benchmark with each rigor and reports when planning pays off.")
         ("wisdom_sp", value(&wisdom_sp_), "Wisdom file for single-precision.")
         ("wisdom_dp", value(&wisdom_dp_), "Wisdom file for double-precision.")
-        ("plan_timelimit", value(&plan_timelimit_)->default_value(-1.0), "Timelimit in seconds for planning in FFTW.");
+        ("plan_timelimit", value(&plan_timelimit_)->default_value(-1.0), "Timelimit in seconds for planning in FFTW. Per-extent budgets (-e <extent>:<seconds>) take precedence.")
+        ("wisdom-cache", value(&wisdom_cache_), "Directory of FFTW wisdom files per CPU model, FFTW version and number of threads. Wisdom is imported at start and newly planned problems are exported.")
+        ("wisdom-export", value(&wisdom_export_)->default_value("end"), "When to export new wisdom to the wisdom cache (end or benchmark).")
+        ("fresh-planner", boost::program_options::bool_switch(&fresh_planner_), "Initialize and clean up FFTW (threads, wisdom) for every benchmark run instead of once per process.")
+        ("r2r", value(&r2r_), "Real-to-real transform kinds of the R2R benchmarks (comma-separated list of redft00, redft10, redft01, redft11, rodft00, rodft10, rodft01, rodft11 or dht, e.g. redft10 = DCT-II), the inverse is the matching DCT/DST. R2R benchmarks are not run without this option.")
+        ("axes", value(&axes_), "Axes of the axis-wise complex transforms (Inplace_Axes_Complex, Outplace_Axes_Complex) of 2D/3D extents. Comma-separated list of axis sets, an axis is an index into the extent (0 = first, strided) or first or last (contiguous), axes of a set are joined by + (e.g. last,first,0+1). Axis-wise benchmarks are not run without this option.")
+        ("split", boost::program_options::bool_switch(&split_), "Run the split-complex benchmarks (Inplace_Split_Complex, Outplace_Split_Complex), which keep real and imaginary parts in separate arrays. Upload and download convert from and to interleaved data.")
+        ("bluestein", boost::program_options::bool_switch(&bluestein_), "Run the Bluestein benchmarks (Inplace_Bluestein_Complex, Outplace_Bluestein_Complex), which compute complex transforms of any size by convolutions of power-of-two size with FFTW. Chirps and their spectra are cached per size.")
+        ("rowcol", boost::program_options::bool_switch(&rowcol_), "Run the row-column benchmarks (Inplace_RowColumn_Complex, Outplace_RowColumn_Complex) of 2D/3D extents, which compute batched 1D FFTW plans along the contiguous axis and rotate the axes by cache-blocked transposes. The time of the 1D passes and the transposes is recorded per run.")
+        ("four-step", boost::program_options::bool_switch(&four_step_), "Run the four-step benchmarks (Inplace_FourStep_Complex, Outplace_FourStep_Complex) of 1D extents, which split a transform of size n = n1*n2 (n1 about sqrt(n)) into batched FFTW plans of size n1 and n2, a twiddle pass and cache-blocked transposes. The time of the FFT passes, the twiddle pass and the transposes is recorded per run.")
+        ("steps", value(&steps_)->default_value("4"), "Algorithm of the four-step benchmarks (4 = strided column FFTs and one transpose, 6 = six-step with three transposes and contiguous FFTs only), comma-separated list allowed.")
+        ("real-packing", value(&real_packing_), "Run the packed real benchmarks (Inplace_Packed_Real, Outplace_Packed_Real) of 1D extents with the given strategies (comma-separated list of half = n/2-point complex FFT of the even and odd samples, even sizes only, or pair = two real signals per complex FFT). Pre- and post-processing time is recorded per run, the signals of --batch are transformed together.")
+        ("transpose-block", value(&transpose_block_)->default_value("32"), "Block size in elements of the transposes of the row-column and four-step benchmarks, comma-separated list allowed.")
+        ("transpose-threads", value(&transpose_threads_)->default_value("0"), "Threads of the transposes and twiddle passes of the row-column and four-step benchmarks (0 = FFTW threads of -n), comma-separated list allowed.")
+        ("stride", value(&stride_)->default_value("1"), "Distance of consecutive elements of the last (contiguous) dimension in the FFT buffers. A comma-separated list (e.g. 1,2,4) runs every benchmark with each stride.")
+        ("pad", value(&pad_)->default_value("0"), "Elements appended to each row of the last dimension in the FFT buffers (leading-dimension padding), comma-separated list allowed.")
+        ("pad-sweep", value(&pad_sweep_)->default_value(0), "Sweeps the leading-dimension padding from 0 to the given number of elements (--pad 0,1,...,k) and reports the transform time of each padding, the fastest is highlighted. The logical extent is kept, the rows are padded by the strides of the FFTW guru interface.")
+        ("batch", value(&batch_)->default_value("1"), "Number of transforms per plan (howmany), all transforms compute the same data. Comma-separated list allowed.")
+        ("batch-pad", value(&batch_pad_)->default_value("0"), "Elements between consecutive transforms of a batch in addition to the array size, comma-separated list allowed.")
+        ("autotune", boost::program_options::bool_switch(&autotune_), "Run every benchmark with each combination of threads (powers of two up to -n), rigor (--rigor list, default estimate,measure,patient) and planner flags (none, destroy-input, conserve-memory, no-simd). Use with --tuning-table and --prune.");
+    }
+
+    /// real-to-real transform kinds, empty if R2R benchmarks are disabled
+    std::vector<std::string> r2r_kinds() const {
+      static const std::vector<std::string> known = {"redft00", "redft10", "redft01", "redft11",
+                                                     "rodft00", "rodft10", "rodft01", "rodft11", "dht"};
+      std::vector<std::string> kinds;
+      std::stringstream ss(r2r_);
+      std::string kind;
+      while(std::getline(ss, kind, ',')) {
+        if(std::find(known.begin(), known.end(), kind) == known.end())
+          throw std::runtime_error("Invalid real-to-real transform kind '"+kind+"'.");
+        kinds.push_back(kind);
+      }
+      return kinds;
+    }
+
+    /// axis sets of axis-wise transforms, empty if axis-wise benchmarks are disabled
+    std::vector<std::string> axes() const {
+      std::vector<std::string> result;
+      std::stringstream ss(axes_);
+      std::string axes;
+      while(std::getline(ss, axes, ','))
+        result.push_back(axes);
+      return result;
+    }
+
+    /**
+     * Layouts of the FFT buffers (--stride, --pad, --batch, --batch-pad) as
+     * variant labels, e.g. "stride=2;pad=8". Empty for dense arrays.
+     */
+    std::vector<std::string> layouts() const {
+      std::vector<std::string> result = {""};
+      add_layout(result, "stride", stride_, "1", 1);
+      if(pad_sweep_ > 0) {
+        if(pad_ != "0")
+          throw std::runtime_error("--pad and --pad-sweep cannot be combined.");
+        std::string pads = "0";
+        for(size_t pad = 1; pad <= pad_sweep_; ++pad)
+          pads += "," + std::to_string(pad);
+        add_layout(result, "pad", pads, "0", 0);
+      } else {
+        add_layout(result, "pad", pad_, "0", 0);
+      }
+      add_layout(result, "batch", batch_, "1", 1);
+      add_layout(result, "batch-pad", batch_pad_, "0", 0);
+      if(result.size() == 1 && result.front().empty())
+        return {};
+      return result;
+    }
+
+    /// largest leading-dimension padding of the pad sweep (0 = no sweep)
+    size_t pad_sweep() const {
+      return pad_sweep_;
+    }
+
+    /// row-column benchmarks are enabled
+    bool rowcol() const {
+      return rowcol_;
+    }
+
+    /**
+     * Transpose configurations of the row-column benchmarks (--transpose-block,
+     * --transpose-threads) as variant labels, e.g. "block=64;transpose-threads=4".
+     * Empty for the defaults.
+     */
+    std::vector<std::string> transpose_variants() const {
+      std::vector<std::string> result = {""};
+      add_layout(result, "block", transpose_block_, "32", 1);
+      add_layout(result, "transpose-threads", transpose_threads_, "0", 0);
+      if(result.size() == 1 && result.front().empty())
+        return {};
+      return result;
+    }
+
+    /// four-step benchmarks are enabled
+    bool four_step() const {
+      return four_step_;
+    }
+
+    /**
+     * Configurations of the four-step benchmarks (--steps and the transpose
+     * configurations) as variant labels, e.g. "steps=6;block=64". Empty for the defaults.
+     */
+    std::vector<std::string> four_step_variants() const {
+      std::stringstream ss(steps_);
+      std::string steps;
+      while(std::getline(ss, steps, ','))
+        if(steps != "4" && steps != "6")
+          throw std::runtime_error("Invalid steps '"+steps+"'.");
+      std::vector<std::string> result = {""};
+      add_layout(result, "steps", steps_, "4", 4);
+      add_layout(result, "block", transpose_block_, "32", 1);
+      add_layout(result, "transpose-threads", transpose_threads_, "0", 0);
+      if(result.size() == 1 && result.front().empty())
+        return {};
+      return result;
+    }
+
+    /**
+     * Packing strategies of the packed real benchmarks (--real-packing) and
+     * batch sizes (--batch) as variant labels, e.g. "packing=pair;batch=8".
+     * Empty if packed real benchmarks are disabled.
+     */
+    std::vector<std::string> packing_variants() const {
+      std::vector<std::string> result;
+      std::stringstream ss(real_packing_);
+      std::string packing;
+      while(std::getline(ss, packing, ',')) {
+        if(packing != "half" && packing != "pair")
+          throw std::runtime_error("Invalid real packing '"+packing+"'.");
+        result.push_back("packing=" + packing);
+      }
+      if(result.empty())
+        return result;
+      add_layout(result, "batch", batch_, "1", 1);
+      return result;
+    }
+
+    /// split-complex benchmarks are enabled
+    bool split() const {
+      return split_;
+    }
+
+    /// Bluestein benchmarks are enabled
+    bool bluestein() const {
+      return bluestein_;
+    }
+
+    /// search threads, rigor and planner flags per benchmark
+    bool autotune() const {
+      return autotune_;
+    }
+
+    /// FFTW planner state is not kept across benchmarks
+    bool fresh_planner() const {
+      return fresh_planner_;
+    }
+
+    /// wisdom cache directory, empty if disabled
+    const std::string& wisdom_cache() const {
+      return wisdom_cache_;
+    }
+
+    /// export wisdom to cache after every benchmark (otherwise at context destroy)
+    bool wisdom_export_per_benchmark() const {
+      if(wisdom_export_ == "benchmark")
+        return true;
+      if(wisdom_export_ == "end")
+        return false;
+      throw std::runtime_error("Invalid wisdom-export (end or benchmark).");
     }
 
     double plan_timelimit() const {
       return plan_timelimit_;
     }
 
+    /// rigor of --rigor, first rigor if a list is given
     unsigned plan_rigor() const {
-      if(rigor_ == "measure")
+      return rigor_flags(plan_rigors().front());
+    }
+
+    /// planning cost of a rigor, estimate is the cheapest
+    static int rigor_rank(const std::string& rigor) {
+      static const std::vector<std::string> order = {"estimate", "measure", "patient", "exhaustive"};
+      return static_cast<int>(std::find(order.begin(), order.end(), rigor) - order.begin());
+    }
+
+    /// rigors to be compared, a single rigor if --rigor is not a list
+    std::vector<std::string> plan_rigors() const {
+      if(rigor_ == "all")
+        return {"estimate", "measure", "patient", "exhaustive"};
+      std::vector<std::string> rigors;
+      std::stringstream ss(rigor_);
+      std::string rigor;
+      while(std::getline(ss, rigor, ','))
+        rigors.push_back(rigor);
+      if(rigors.empty())
+        throw std::runtime_error("Invalid FFTW rigor.");
+      if(rigors.size() > 1) {
+        for(const auto& r : rigors) {
+          if(r == "wisdom")
+            throw std::runtime_error("Rigor 'wisdom' cannot be compared with other rigors.");
+          rigor_flags(r); // validates rigor
+        }
+      }
+      return rigors;
+    }
+
+    std::string plan_rigor_str() const {
+      return rigor_;
+    }
+
+    template<typename T_Precision>
+    std::string wisdom_file() {
+      if(std::is_same<T_Precision, float>::value)
+        return wisdom_sp_;
+      if(std::is_same<T_Precision, double>::value)
+        return wisdom_dp_;
+      throw std::runtime_error("Precision type not supported by FFTW.");
+    }
+
+    static unsigned rigor_flags(const std::string& rigor) {
+      if(rigor == "measure")
         return FFTW_MEASURE;
-      if(rigor_ == "estimate")
+      if(rigor == "estimate")
         return FFTW_ESTIMATE;
-      if(rigor_ == "patient")
+      if(rigor == "patient")
         return FFTW_PATIENT;
-      if(rigor_ == "wisdom"){
+      if(rigor == "wisdom"){
         if(!native_fftw()) {
 #if defined (USE_ESSL)
           throw std::runtime_error("wisdom rigor not supported with ESSL wrappers.");
@@ -81,30 +301,66 @@ namespace fftw {
         return 0;   // FFTW_WISDOM_ONLY is not defined for ESSL -- but this line won't be reached.
 #endif
       }
-      if(rigor_ == "exhaustive")
+      if(rigor == "exhaustive")
         return FFTW_EXHAUSTIVE;
       throw std::runtime_error("Invalid FFTW rigor.");
     }
 
-    std::string plan_rigor_str() const {
-      return rigor_;
-    }
+  private:
 
-    template<typename T_Precision>
-    std::string wisdom_file() {
-      if(std::is_same<T_Precision, float>::value)
-        return wisdom_sp_;
-      if(std::is_same<T_Precision, double>::value)
-        return wisdom_dp_;
-      throw std::runtime_error("Precision type not supported by FFTW.");
+    /// crosses layout labels with the values of a layout option, unless the default is given
+    static void add_layout(std::vector<std::string>& labels,
+                           const std::string& key,
+                           const std::string& list,
+                           const std::string& default_list,
+                           size_t min) {
+      if(list == default_list)
+        return;
+      std::vector<std::string> values;
+      std::stringstream ss(list);
+      std::string value;
+      while(std::getline(ss, value, ',')) {
+        size_t pos = 0;
+        unsigned long long v = 0;
+        try {
+          v = std::stoull(value, &pos);
+        } catch(const std::logic_error&) {
+          pos = 0;
+        }
+        if(pos == 0 || pos != value.size() || v < min)
+          throw std::runtime_error("Invalid "+key+" '"+value+"'.");
+        values.push_back(key + "=" + value);
+      }
+      std::vector<std::string> result;
+      for(const auto& label : labels)
+        for(const auto& v : values)
+          result.push_back(label.empty() ? v : label + ";" + v);
+      labels = result;
     }
 
-  private:
-
     double plan_timelimit_ = -1;
     std::string rigor_;
     std::string wisdom_sp_;
     std::string wisdom_dp_;
+    std::string wisdom_cache_;
+    std::string wisdom_export_;
+    std::string r2r_;
+    std::string axes_;
+    std::string stride_;
+    std::string pad_;
+    std::string batch_;
+    std::string batch_pad_;
+    std::string transpose_block_;
+    std::string transpose_threads_;
+    std::string steps_;
+    std::string real_packing_;
+    size_t pad_sweep_ = 0;
+    bool fresh_planner_ = false;
+    bool autotune_ = false;
+    bool split_ = false;
+    bool bluestein_ = false;
+    bool rowcol_ = false;
+    bool four_step_ = false;
   };
 
   namespace traits{
@@ -160,6 +416,14 @@ namespace fftw {
       static void cleanup(){
         fftw_cleanup();
       }
+
+      static void set_timelimit(double timelimit){
+#ifndef USE_ESSL
+        fftw_set_timelimit(timelimit);
+#else
+        gearshifft::ignore_unused(timelimit);
+#endif
+      }
     };
 
     template <>
@@ -167,6 +431,14 @@ namespace fftw {
       static void cleanup(){
         fftwf_cleanup();
       }
+
+      static void set_timelimit(double timelimit){
+#ifndef USE_ESSL
+        fftwf_set_timelimit(timelimit);
+#else
+        gearshifft::ignore_unused(timelimit);
+#endif
+      }
     };
 
     //http://www.fftw.org/fftw3_doc/Usage-of-Multi_002dthreaded-FFTW.html
@@ -186,8 +458,8 @@ namespace fftw {
 #endif
       }
 
-      static void plan_with_threads(int nthreads = -1,
-                                    double timelimit=FFTW_NO_TIMELIMIT){
+      /// sets the number of threads of subsequent plans, the time limit is set by no_thread_api
+      static void plan_with_threads(int nthreads = -1){
 #ifndef USE_ESSL
         int av_procs = std::thread::hardware_concurrency();
 
@@ -195,7 +467,6 @@ namespace fftw {
           nthreads = av_procs;
 
         fftw_plan_with_nthreads(nthreads);
-        fftw_set_timelimit(timelimit);
 #endif
       }
 
@@ -219,8 +490,8 @@ namespace fftw {
 #endif
       }
 
-      static void plan_with_threads(int nthreads = -1,
-                                    double timelimit=FFTW_NO_TIMELIMIT){
+      /// sets the number of threads of subsequent plans, the time limit is set by no_thread_api
+      static void plan_with_threads(int nthreads = -1){
 #ifndef USE_ESSL
         int av_procs = std::thread::hardware_concurrency();
 
@@ -228,7 +499,6 @@ namespace fftw {
           nthreads = av_procs;
 
         fftwf_plan_with_nthreads(nthreads);
-        fftwf_set_timelimit(timelimit);
 #endif
       }
 
@@ -246,6 +516,155 @@ namespace fftw {
     };
 
 
+    /// a*b, throws if the product does not fit into ptrdiff_t (FFTW sizes and strides)
+    inline size_t checked_size(size_t a, size_t b) {
+      if(a != 0 && b > static_cast<size_t>(std::numeric_limits<std::ptrdiff_t>::max())/a)
+        throw std::runtime_error("FFT size exceeds the address range of FFTW (ptrdiff_t).");
+      return a*b;
+    }
+
+    /**
+     * Memory layout of the input and the output array of a plan in elements
+     * of the respective array. Default values describe dense arrays.
+     */
+    struct layout {
+      /// distance of consecutive elements of the last dimension
+      size_t in_stride = 1;
+      size_t out_stride = 1;
+      /// distance of consecutive rows (last dimension), 0 = dense
+      size_t in_pitch = 0;
+      size_t out_pitch = 0;
+      /// number of transforms (howmany)
+      size_t howmany = 1;
+      /// distance of consecutive transforms
+      size_t in_dist = 0;
+      size_t out_dist = 0;
+      /// transformed dimensions of C2C transforms (bit mask, 0 = all), the others are looped
+      unsigned axes = 0;
+    };
+
+#ifndef USE_ESSL
+    /**
+     * guru64 dimensions of a row-major array (last dimension is contiguous).
+     * Strides are counted in elements of the input and the output array,
+     * whose last dimension has the physical length in_last and out_last
+     * (padded for in-place real data, n/2+1 for the complex side of R2C/C2R),
+     * unless the layout gives strided or padded rows.
+     */
+    template<size_t NDims>
+    std::array<fftw_iodim64, NDims> iodims(const std::array<std::size_t,NDims>& shape,
+                                           size_t in_last,
+                                           size_t out_last,
+                                           const layout& _layout = layout()) {
+      std::array<fftw_iodim64, NDims> dims;
+      size_t is = _layout.in_stride;
+      size_t os = _layout.out_stride;
+      for(size_t i = NDims; i-- > 0; ) {
+        dims[i].n = static_cast<std::ptrdiff_t>(checked_size(shape[i], 1));
+        dims[i].is = static_cast<std::ptrdiff_t>(is);
+        dims[i].os = static_cast<std::ptrdiff_t>(os);
+        if(i+1 == NDims) {
+          is = _layout.in_pitch > 0 ? _layout.in_pitch : checked_size(is, in_last);
+          os = _layout.out_pitch > 0 ? _layout.out_pitch : checked_size(os, out_last);
+        } else {
+          is = checked_size(is, shape[i]);
+          os = checked_size(os, shape[i]);
+        }
+      }
+      return dims;
+    }
+
+    /// guru64 howmany dimension of a batch of transforms (rank 0 for a single transform)
+    inline fftw_iodim64 howmany_dims(const layout& _layout) {
+      fftw_iodim64 dim;
+      dim.n = static_cast<std::ptrdiff_t>(checked_size(_layout.howmany, 1));
+      dim.is = static_cast<std::ptrdiff_t>(checked_size(_layout.in_dist, 1));
+      dim.os = static_cast<std::ptrdiff_t>(checked_size(_layout.out_dist, 1));
+      return dim;
+    }
+
+    inline int howmany_rank(const layout& _layout) {
+      return _layout.howmany > 1 ? 1 : 0;
+    }
+
+    /**
+     * Splits the dimensions into transformed dimensions (layout.axes) and
+     * loop dimensions, which are appended to the howmany dimension of a batch.
+     */
+    template<size_t NDims>
+    void split_dims(const std::array<fftw_iodim64, NDims>& all,
+                    const layout& _layout,
+                    std::vector<fftw_iodim64>& dims,
+                    std::vector<fftw_iodim64>& loops) {
+      dims.clear();
+      loops.clear();
+      if(howmany_rank(_layout) > 0)
+        loops.push_back(howmany_dims(_layout));
+      for(size_t i = 0; i < NDims; ++i) {
+        if(_layout.axes == 0 || (_layout.axes & (1u << i)))
+          dims.push_back(all[i]);
+        else
+          loops.push_back(all[i]);
+      }
+    }
+#else
+    /// extents for the basic interface of the ESSL wrappers, which only takes int
+    template<size_t NDims>
+    std::array<int, NDims> int_shape(const std::array<std::size_t,NDims>& shape) {
+      std::array<int, NDims> converted;
+      for(size_t i = 0; i < NDims; ++i) {
+        if(shape[i] > static_cast<size_t>(std::numeric_limits<int>::max()))
+          throw std::runtime_error("FFT extent exceeds the int range of the FFTW basic interface.");
+        converted[i] = static_cast<int>(shape[i]);
+      }
+      return converted;
+    }
+#endif
+
+#ifndef USE_ESSL
+    inline fftw_r2r_kind r2r_kind_by_name(const std::string& name) {
+      if(name == "redft00") return FFTW_REDFT00;
+      if(name == "redft10") return FFTW_REDFT10;
+      if(name == "redft01") return FFTW_REDFT01;
+      if(name == "redft11") return FFTW_REDFT11;
+      if(name == "rodft00") return FFTW_RODFT00;
+      if(name == "rodft10") return FFTW_RODFT10;
+      if(name == "rodft01") return FFTW_RODFT01;
+      if(name == "rodft11") return FFTW_RODFT11;
+      if(name == "dht") return FFTW_DHT;
+      throw std::runtime_error("Invalid real-to-real transform kind '"+name+"'.");
+    }
+
+    /// kind which inverts the transform up to scaling (DCT-II <-> DCT-III, ...)
+    inline fftw_r2r_kind r2r_inverse(fftw_r2r_kind kind) {
+      switch(kind) {
+      case FFTW_REDFT10: return FFTW_REDFT01;
+      case FFTW_REDFT01: return FFTW_REDFT10;
+      case FFTW_RODFT10: return FFTW_RODFT01;
+      case FFTW_RODFT01: return FFTW_RODFT10;
+      default: return kind;
+      }
+    }
+
+    /// logical size N of an extent n, the round trip is scaled by N
+    inline size_t r2r_logical_size(fftw_r2r_kind kind, size_t n) {
+      switch(kind) {
+      case FFTW_REDFT00:
+        if(n < 2)
+          throw std::runtime_error("REDFT00 needs at least 2 points per axis.");
+        return 2*(n-1);
+      case FFTW_RODFT00: return 2*(n+1);
+      case FFTW_DHT: return n;
+      default: return 2*n;
+      }
+    }
+#endif
+
+    /**
+     * Plans are created by the guru64 interface, so sizes and strides are
+     * not limited to int. The layout gives strides, row pitches (e.g. the
+     * padded real array of in-place R2C and C2R transforms) and batches.
+     */
     template<typename T_Precision=float>
     struct plan
     {
@@ -270,19 +689,20 @@ namespace fftw {
                              RealType* _in,
                              ComplexType* _out,
                              fftw_direction _dir = fftw_direction::forward,
-                             unsigned plan_flags = FFTW_MEASURE){
+                             unsigned plan_flags = FFTW_MEASURE,
+                             const layout& _layout = layout()){
 
         gearshifft::ignore_unused(_dir);
-        std::array<int,NDims> converted;
-        for(size_t i = 0;i < NDims;++i)
-          converted[i] = _shape[i];
-
-        PlanType value = fftwf_plan_dft_r2c(NDims,
-                                            converted.data(),
-                                            _in,
-                                            _out,
-                                            plan_flags );
-        return value;
+#ifndef USE_ESSL
+        auto dims = iodims(_shape, _shape.back(), _shape.back()/2+1, _layout);
+        auto howmany = howmany_dims(_layout);
+        return fftwf_plan_guru64_dft_r2c(NDims, dims.data(), howmany_rank(_layout), &howmany,
+                                         _in, _out, plan_flags);
+#else
+        gearshifft::ignore_unused(_layout);
+        auto converted = int_shape(_shape);
+        return fftwf_plan_dft_r2c(NDims, converted.data(), _in, _out, plan_flags);
+#endif
       }
 
       template <size_t NDims>
@@ -290,19 +710,20 @@ namespace fftw {
                              ComplexType* _in,
                              RealType* _out,
                              fftw_direction _dir = fftw_direction::forward,
-                             unsigned plan_flags = FFTW_MEASURE){
+                             unsigned plan_flags = FFTW_MEASURE,
+                             const layout& _layout = layout()){
 
         gearshifft::ignore_unused(_dir);
-        std::array<int,NDims> converted;
-        for(size_t i = 0;i < NDims;++i)
-          converted[i] = _shape[i];
-
-        PlanType value = fftwf_plan_dft_c2r(NDims,
-                                            converted.data(),
-                                            _in,
-                                            _out,
-                                            plan_flags );
-        return value;
+#ifndef USE_ESSL
+        auto dims = iodims(_shape, _shape.back()/2+1, _shape.back(), _layout);
+        auto howmany = howmany_dims(_layout);
+        return fftwf_plan_guru64_dft_c2r(NDims, dims.data(), howmany_rank(_layout), &howmany,
+                                         _in, _out, plan_flags);
+#else
+        gearshifft::ignore_unused(_layout);
+        auto converted = int_shape(_shape);
+        return fftwf_plan_dft_c2r(NDims, converted.data(), _in, _out, plan_flags);
+#endif
       }
 
       template <size_t NDims>
@@ -310,21 +731,63 @@ namespace fftw {
                              ComplexType* _in,
                              ComplexType* _out,
                              fftw_direction _dir = fftw_direction::forward,
-                             unsigned plan_flags = FFTW_MEASURE){
+                             unsigned plan_flags = FFTW_MEASURE,
+                             const layout& _layout = layout()){
 
-        std::array<int,NDims> converted;
-        for(size_t i = 0;i < NDims;++i)
-          converted[i] = _shape[i];
+#ifndef USE_ESSL
+        std::vector<fftw_iodim64> dims;
+        std::vector<fftw_iodim64> loops;
+        split_dims(iodims(_shape, _shape.back(), _shape.back(), _layout), _layout, dims, loops);
+        return fftwf_plan_guru64_dft(static_cast<int>(dims.size()), dims.data(),
+                                     static_cast<int>(loops.size()), loops.data(),
+                                     _in, _out, static_cast<int>(_dir), plan_flags);
+#else
+        gearshifft::ignore_unused(_layout);
+        auto converted = int_shape(_shape);
+        return fftwf_plan_dft(NDims, converted.data(), _in, _out,
+                              static_cast<int>(_dir), plan_flags);
+#endif
+      }
 
+#ifndef USE_ESSL
+      /// real-to-real transform of the same kind along all dimensions
+      template <size_t NDims>
+      static PlanType create_r2r(const std::array<std::size_t,NDims>& _shape,
+                                 RealType* _in,
+                                 RealType* _out,
+                                 fftw_r2r_kind _kind,
+                                 unsigned plan_flags = FFTW_MEASURE,
+                                 const layout& _layout = layout()){
+
+        auto dims = iodims(_shape, _shape.back(), _shape.back(), _layout);
+        auto howmany = howmany_dims(_layout);
+        std::array<fftw_r2r_kind, NDims> kinds;
+        kinds.fill(_kind);
+        return fftwf_plan_guru64_r2r(NDims, dims.data(), howmany_rank(_layout), &howmany,
+                                     _in, _out, kinds.data(), plan_flags);
+      }
 
-        PlanType value = fftwf_plan_dft(NDims,
-                                        converted.data(),
-                                        _in,
-                                        _out,
-                                        static_cast<int>(_dir),
-                                        plan_flags );
-        return value;
+      /**
+       * Complex transform of split arrays (real and imaginary part), the
+       * inverse transform is planned with swapped real and imaginary parts.
+       */
+      template <size_t NDims>
+      static PlanType create_split(const std::array<std::size_t,NDims>& _shape,
+                                   RealType* _ri,
+                                   RealType* _ii,
+                                   RealType* _ro,
+                                   RealType* _io,
+                                   unsigned plan_flags = FFTW_MEASURE,
+                                   const layout& _layout = layout()){
+
+        std::vector<fftw_iodim64> dims;
+        std::vector<fftw_iodim64> loops;
+        split_dims(iodims(_shape, _shape.back(), _shape.back(), _layout), _layout, dims, loops);
+        return fftwf_plan_guru64_split_dft(static_cast<int>(dims.size()), dims.data(),
+                                           static_cast<int>(loops.size()), loops.data(),
+                                           _ri, _ii, _ro, _io, plan_flags);
       }
+#endif
 
     };
 
@@ -347,26 +810,25 @@ namespace fftw {
 
       }
 
-      // //ND
       template <size_t NDims>
       static PlanType create(const std::array<std::size_t,NDims>& _shape,
                              RealType* _in,
                              ComplexType* _out,
                              fftw_direction _dir = fftw_direction::forward,
-                             unsigned plan_flags = FFTW_MEASURE){
+                             unsigned plan_flags = FFTW_MEASURE,
+                             const layout& _layout = layout()){
 
         gearshifft::ignore_unused(_dir);
-        std::array<int,NDims> converted;
-        for(size_t i = 0;i < NDims;++i)
-          converted[i] = _shape[i];
-
-
-        PlanType value = fftw_plan_dft_r2c(NDims,
-                                           converted.data(),
-                                           _in,
-                                           _out,
-                                           plan_flags );
-        return value;
+#ifndef USE_ESSL
+        auto dims = iodims(_shape, _shape.back(), _shape.back()/2+1, _layout);
+        auto howmany = howmany_dims(_layout);
+        return fftw_plan_guru64_dft_r2c(NDims, dims.data(), howmany_rank(_layout), &howmany,
+                                        _in, _out, plan_flags);
+#else
+        gearshifft::ignore_unused(_layout);
+        auto converted = int_shape(_shape);
+        return fftw_plan_dft_r2c(NDims, converted.data(), _in, _out, plan_flags);
+#endif
       }
 
       template <size_t NDims>
@@ -374,20 +836,20 @@ namespace fftw {
                              ComplexType* _in,
                              RealType* _out,
                              fftw_direction _dir = fftw_direction::forward,
-                             unsigned plan_flags = FFTW_MEASURE){
+                             unsigned plan_flags = FFTW_MEASURE,
+                             const layout& _layout = layout()){
 
         gearshifft::ignore_unused(_dir);
-        std::array<int,NDims> converted;
-        for(size_t i = 0;i < NDims;++i)
-          converted[i] = _shape[i];
-
-
-        PlanType value = fftw_plan_dft_c2r(NDims,
-                                           converted.data(),
-                                           _in,
-                                           _out,
-                                           plan_flags );
-        return value;
+#ifndef USE_ESSL
+        auto dims = iodims(_shape, _shape.back()/2+1, _shape.back(), _layout);
+        auto howmany = howmany_dims(_layout);
+        return fftw_plan_guru64_dft_c2r(NDims, dims.data(), howmany_rank(_layout), &howmany,
+                                        _in, _out, plan_flags);
+#else
+        gearshifft::ignore_unused(_layout);
+        auto converted = int_shape(_shape);
+        return fftw_plan_dft_c2r(NDims, converted.data(), _in, _out, plan_flags);
+#endif
       }
 
       template <size_t NDims>
@@ -395,26 +857,109 @@ namespace fftw {
                              ComplexType* _in,
                              ComplexType* _out,
                              fftw_direction _dir = fftw_direction::forward,
-                             unsigned plan_flags = FFTW_MEASURE){
+                             unsigned plan_flags = FFTW_MEASURE,
+                             const layout& _layout = layout()){
 
-        std::array<int,NDims> converted;
-        for(size_t i = 0;i < NDims;++i)
-          converted[i] = _shape[i];
+#ifndef USE_ESSL
+        std::vector<fftw_iodim64> dims;
+        std::vector<fftw_iodim64> loops;
+        split_dims(iodims(_shape, _shape.back(), _shape.back(), _layout), _layout, dims, loops);
+        return fftw_plan_guru64_dft(static_cast<int>(dims.size()), dims.data(),
+                                    static_cast<int>(loops.size()), loops.data(),
+                                    _in, _out, static_cast<int>(_dir), plan_flags);
+#else
+        gearshifft::ignore_unused(_layout);
+        auto converted = int_shape(_shape);
+        return fftw_plan_dft(NDims, converted.data(), _in, _out,
+                             static_cast<int>(_dir), plan_flags);
+#endif
+      }
 
+#ifndef USE_ESSL
+      /// real-to-real transform of the same kind along all dimensions
+      template <size_t NDims>
+      static PlanType create_r2r(const std::array<std::size_t,NDims>& _shape,
+                                 RealType* _in,
+                                 RealType* _out,
+                                 fftw_r2r_kind _kind,
+                                 unsigned plan_flags = FFTW_MEASURE,
+                                 const layout& _layout = layout()){
+
+        auto dims = iodims(_shape, _shape.back(), _shape.back(), _layout);
+        auto howmany = howmany_dims(_layout);
+        std::array<fftw_r2r_kind, NDims> kinds;
+        kinds.fill(_kind);
+        return fftw_plan_guru64_r2r(NDims, dims.data(), howmany_rank(_layout), &howmany,
+                                    _in, _out, kinds.data(), plan_flags);
+      }
 
-        PlanType value = fftw_plan_dft(NDims,
-                                       converted.data(),
-                                       _in,
-                                       _out,
-                                       static_cast<int>(_dir),
-                                       plan_flags );
-        return value;
+      /**
+       * Complex transform of split arrays (real and imaginary part), the
+       * inverse transform is planned with swapped real and imaginary parts.
+       */
+      template <size_t NDims>
+      static PlanType create_split(const std::array<std::size_t,NDims>& _shape,
+                                   RealType* _ri,
+                                   RealType* _ii,
+                                   RealType* _ro,
+                                   RealType* _io,
+                                   unsigned plan_flags = FFTW_MEASURE,
+                                   const layout& _layout = layout()){
+
+        std::vector<fftw_iodim64> dims;
+        std::vector<fftw_iodim64> loops;
+        split_dims(iodims(_shape, _shape.back(), _shape.back(), _layout), _layout, dims, loops);
+        return fftw_plan_guru64_split_dft(static_cast<int>(dims.size()), dims.data(),
+                                          static_cast<int>(loops.size()), loops.data(),
+                                          _ri, _ii, _ro, _io, plan_flags);
       }
+#endif
 
     };
   }  // namespace traits
 
 
+  template<typename T_Precision>
+  struct ImportWisdom {
+
+    FftwOptions& options;
+
+    void operator()() {
+
+      if(!native_fftw())
+        throw std::runtime_error("Wisdom files are only supported by native fftw, unable to proceed");
+
+#ifndef USE_ESSL
+      std::string filename = options.template wisdom_file<T_Precision>();
+      std::string source;
+      std::ifstream ifs;
+      std::stringstream ss;
+      std::string line;
+      ifs.open(filename.c_str(), std::ifstream::in);
+      if(!ifs.good())
+        throw std::runtime_error("Wisdom file not accessable.");
+
+      if(ifs.is_open()) {
+        while ( getline (ifs,line) )
+        {
+          ss << line;
+        }
+        ifs.close();
+        source = ss.str();
+      }
+
+      int imported = 0;
+      if(std::is_same<T_Precision,float>::value)
+        imported = fftwf_import_wisdom_from_string(source.c_str());
+      if(std::is_same<T_Precision,double>::value)
+        imported = fftw_import_wisdom_from_string(source.c_str());
+      if(!imported)
+        throw std::runtime_error("Wisdom file could not be loaded.");
+#endif
+    }
+
+  }; // FftwWisdomLoader
+
   /**
    * FFTW context.
    */
@@ -449,74 +994,413 @@ namespace fftw {
       return msg.str();
     }
 
-    std::string get_used_device_properties() {
-
+    /// number of threads used by FFTW plans
+    static size_t used_threads() {
 #if defined(GEARSHIFFT_BACKEND_FFTW_THREADS) && GEARSHIFFT_BACKEND_FFTW_THREADS==1
-      // Returns the number of supported concurrent threads of implementation
       size_t maxndevs = std::thread::hardware_concurrency();
       size_t ndevs = options().getNumberDevices();
       if(maxndevs==0)
         maxndevs = 1;
       if( ndevs==0 || ndevs>maxndevs )
         ndevs = maxndevs;
+      return ndevs;
+#else
+      return 0;
+#endif
+    }
+
+    /// planner state is created and released for every FftwImpl (--fresh-planner)
+    static bool fresh_planner() {
+      return options().fresh_planner();
+    }
+
+    /**
+     * Plan configuration of a benchmark variant (--rigor <list>, --autotune),
+     * default values select the configuration given by the options.
+     */
+    struct PlanConfig {
+      std::string rigor;
+      /// number of plan threads, 0 = used_threads()
+      size_t threads = 0;
+      /// none, destroy-input, conserve-memory or no-simd
+      std::string flags;
+      /// real-to-real transform kind of R2R benchmarks
+      std::string r2r;
+      /// transformed axes of axis-wise benchmarks, see axes_mask()
+      std::string axes;
+      /// layout of the FFT buffers, see FftwOptions::layouts()
+      size_t stride = 1;
+      size_t pad = 0;
+      size_t batch = 1;
+      size_t batch_pad = 0;
+    };
+
+    static PlanConfig& selected() {
+      static PlanConfig config;
+      return config;
+    }
+
+    /// every benchmark is run in several plan configurations
+    static bool compare_variants() {
+      return options().autotune() || options().plan_rigors().size() > 1;
+    }
+
+    /**
+     * Variant labels, e.g. "rigor=patient" or with --autotune
+     * "threads=4;rigor=measure;flags=none", for each layout of the buffers
+     * ("stride=2;rigor=patient"). Empty if no variants are compared.
+     */
+    static std::vector<std::string> variants(bool inplace) {
+      const auto configs = plan_configs(inplace);
+      const auto layouts = options().layouts();
+      if(layouts.empty())
+        return configs;
+      if(configs.empty())
+        return layouts;
+      std::vector<std::string> result;
+      for(const auto& layout : layouts)
+        for(const auto& config : configs)
+          result.push_back(layout + ";" + config);
+      return result;
+    }
+
+    /**
+     * Variants of the same transform and layout (group) are compared by
+     * pruning and the amortization report, the group consists of the
+     * r2r kind, the axes and the layout of the variant label.
+     */
+    static std::string variant_group(const std::string& variant) {
+      static const std::vector<std::string> keys = {"r2r", "axes", "stride", "pad", "batch", "batch-pad"};
+      std::string group;
+      std::stringstream ss(variant);
+      std::string token;
+      while(std::getline(ss, token, ';')) {
+        if(std::find(keys.begin(), keys.end(), token.substr(0, token.find('='))) != keys.end())
+          group += (group.empty() ? "" : ";") + token;
+      }
+      return group;
+    }
+
+    /// padding token of the variant (e.g. "pad=3") with --pad-sweep, otherwise empty
+    static std::string variant_sweep(const std::string& variant) {
+      if(options().pad_sweep() == 0)
+        return "";
+      std::stringstream ss(variant);
+      std::string token;
+      while(std::getline(ss, token, ';')) {
+        if(token.compare(0, 4, "pad=") == 0)
+          return token;
+      }
+      return "";
+    }
+
+    /**
+     * Plan configurations to be compared (--rigor list, --autotune).
+     * destroy-input only applies to out-of-place transforms.
+     */
+    static std::vector<std::string> plan_configs(bool inplace) {
+      std::vector<std::string> result;
+      if(!compare_variants())
+        return result;
+      std::vector<std::string> rigors = options().plan_rigors();
+      // cheapest rigor first, so pruning stops the expensive plans
+      std::stable_sort(rigors.begin(), rigors.end(),
+                       [](const std::string& a, const std::string& b) {
+                         return FftwOptions::rigor_rank(a) < FftwOptions::rigor_rank(b);
+                       });
+      if(!options().autotune()) {
+        for(const auto& rigor : rigors)
+          result.push_back("rigor=" + rigor);
+        return result;
+      }
+      if(rigors.size() < 2)
+        rigors = {"estimate", "measure", "patient"};
+      std::vector<std::string> flags = {"none"};
+#ifndef USE_ESSL
+      if(!inplace)
+        flags.push_back("destroy-input");
+      flags.push_back("conserve-memory");
+      flags.push_back("no-simd");
+#else
+      gearshifft::ignore_unused(inplace);
+#endif
+      std::vector<size_t> threads;
+      const size_t nthreads = used_threads();
+      for(size_t t = 1; t < nthreads; t *= 2)
+        threads.push_back(t);
+      threads.push_back(nthreads); // 0 = no thread support
+      std::reverse(threads.begin(), threads.end());
+      for(const auto& rigor : rigors) {
+        for(size_t t : threads) {
+          for(const auto& flag : flags) {
+            std::stringstream label;
+            if(t > 0)
+              label << "threads=" << t << ";";
+            label << "rigor=" << rigor << ";flags=" << flag;
+            result.push_back(label.str());
+          }
+        }
+      }
+      return result;
+    }
+
+    /// selects plan configuration of the next FftwImpl instances, empty string selects default
+    static void select_variant(const std::string& variant) {
+      PlanConfig config;
+      std::stringstream ss(variant);
+      std::string token;
+      while(std::getline(ss, token, ';')) {
+        const auto pos = token.find('=');
+        if(pos == std::string::npos)
+          throw std::runtime_error("Invalid FFTW plan variant '"+variant+"'.");
+        const std::string key = token.substr(0, pos);
+        const std::string value = token.substr(pos+1);
+        if(key == "rigor") {
+          FftwOptions::rigor_flags(value); // validates rigor
+          config.rigor = value;
+        } else if(key == "threads") {
+          config.threads = std::stoul(value);
+        } else if(key == "flags") {
+          config.flags = value;
+        } else if(key == "r2r") {
+          config.r2r = value;
+        } else if(key == "axes") {
+          config.axes = value;
+        } else if(key == "stride") {
+          config.stride = std::stoul(value);
+        } else if(key == "pad") {
+          config.pad = std::stoul(value);
+        } else if(key == "batch") {
+          config.batch = std::stoul(value);
+        } else if(key == "batch-pad") {
+          config.batch_pad = std::stoul(value);
+        } else
+          throw std::runtime_error("Invalid FFTW plan variant '"+variant+"'.");
+      }
+      selected() = config;
+    }
+
+    /// rigor and planner flags of the selected plan configuration
+    static unsigned plan_flags() {
+      const auto& config = selected();
+      unsigned flags = config.rigor.empty() ? options().plan_rigor()
+                                            : FftwOptions::rigor_flags(config.rigor);
+#ifndef USE_ESSL
+      if(config.flags == "destroy-input")
+        flags |= FFTW_DESTROY_INPUT;
+      else if(config.flags == "conserve-memory")
+        flags |= FFTW_CONSERVE_MEMORY;
+      else if(config.flags == "no-simd")
+        flags |= FFTW_NO_SIMD;
+      else
+#endif
+      if(!config.flags.empty() && config.flags != "none")
+        throw std::runtime_error("Invalid FFTW planner flags '"+config.flags+"'.");
+      return flags;
+    }
+
+    /// real-to-real transform kind of the selected plan configuration
+    static std::string r2r_kind() {
+      if(!selected().r2r.empty())
+        return selected().r2r;
+      const auto kinds = options().r2r_kinds();
+      return kinds.empty() ? "redft10" : kinds.front();
+    }
+
+    /// indices of an axis set, e.g. "0+2" or "last" (see --axes)
+    static std::vector<size_t> axes_indices(const std::string& axes, size_t ndim) {
+      if(axes.empty() || axes.back() == '+')
+        throw std::runtime_error("Invalid axes '"+axes+"'.");
+      std::vector<size_t> indices;
+      std::stringstream ss(axes);
+      std::string axis;
+      while(std::getline(ss, axis, '+')) {
+        if(axis == "first") {
+          indices.push_back(0);
+        } else if(axis == "last") {
+          indices.push_back(ndim-1);
+        } else if(!axis.empty() && axis.size() <= 2
+                  && std::all_of(axis.begin(), axis.end(),
+                                 [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; })) {
+          indices.push_back(std::stoul(axis));
+        } else {
+          throw std::runtime_error("Invalid axes '"+axes+"'.");
+        }
+      }
+      return indices;
+    }
+
+    /// whether all axes of an axis set exist in ndim dimensions
+    static bool axes_exist(const std::string& axes, size_t ndim) {
+      const auto indices = axes_indices(axes, ndim);
+      return std::all_of(indices.begin(), indices.end(), [ndim](size_t i) { return i < ndim; });
+    }
+
+    /**
+     * Bit mask of the axes of an axis set, e.g. "0+2" or "last" (see --axes).
+     * Throws if an axis does not exist in ndim dimensions.
+     */
+    static unsigned axes_mask(const std::string& axes, size_t ndim) {
+      unsigned mask = 0;
+      for(size_t index : axes_indices(axes, ndim)) {
+        if(index >= ndim) {
+          throw std::runtime_error("Axis "+std::to_string(index)+" of axes '"+axes+"' does not exist in "
+                                   +std::to_string(ndim)+" dimensions.");
+        }
+        mask |= 1u << index;
+      }
+      return mask;
+    }
+
+    /// number of threads of the selected plan configuration
+    static size_t plan_threads() {
+      return selected().threads > 0 ? selected().threads : used_threads();
+    }
+
+    /// initializes FFTW threads and planner settings of a precision
+    template<typename T_Precision>
+    static void init_planner() {
+#if defined(GEARSHIFFT_BACKEND_FFTW_THREADS) && GEARSHIFFT_BACKEND_FFTW_THREADS==1
+      if( traits::thread_api<T_Precision>::init_threads()==0 )
+        throw std::runtime_error("fftw thread initialization failed.");
+
+      traits::thread_api<T_Precision>::plan_with_threads(options().getNumberDevices());
+#endif
+      // the time limit also applies to serial FFTW
+      set_plan_timelimit<T_Precision>();
+    }
+
+    /**
+     * Threads and time limit (--plan_timelimit) of the next plans of a precision
+     * by the selected plan configuration, for clients built from several FFTW plans.
+     */
+    template<typename T_Precision>
+    static void prepare_plans() {
+#if defined(GEARSHIFFT_BACKEND_FFTW_THREADS) && GEARSHIFFT_BACKEND_FFTW_THREADS==1
+      traits::thread_api<T_Precision>::plan_with_threads(static_cast<int>(plan_threads()));
+#endif
+      set_plan_timelimit<T_Precision>();
+    }
+
+    template<typename T_Precision>
+    static void set_plan_timelimit() {
+      const double timelimit = options().plan_timelimit();
+      traits::no_thread_api<T_Precision>::set_timelimit(timelimit > 0.0 ? timelimit : FFTW_NO_TIMELIMIT);
+    }
+
+    /// imports wisdom cache (--wisdom-cache) and wisdom file (rigor wisdom) of a precision
+    template<typename T_Precision>
+    static void import_wisdom() {
+#ifndef USE_ESSL
+      if(wisdom::Cache<T_Precision>::instance().enabled())
+        wisdom::Cache<T_Precision>::instance().import();
+      if(options().plan_rigor() == FFTW_WISDOM_ONLY && native_fftw()
+         && !options().wisdom_file<T_Precision>().empty())
+        ImportWisdom<T_Precision>{options()}();
+#endif
+    }
+
+    /// releases threads, plans and wisdom of a precision
+    template<typename T_Precision>
+    static void cleanup_planner() {
+#if defined(GEARSHIFFT_BACKEND_FFTW_THREADS) && GEARSHIFFT_BACKEND_FFTW_THREADS==1
+      traits::thread_api<T_Precision>::cleanup_threads();
+#else
+      traits::no_thread_api<T_Precision>::cleanup();
+#endif
+    }
+
+    /**
+     * Initializes FFTW and imports wisdom once for all benchmarks,
+     * unless a fresh planner is used for every benchmark.
+     */
+    void create() {
+      // loops of the harness (test data, validation) use the CPU threads of the benchmark (-n)
+      parallel::set_threads(options().getNumberDevices());
+      options().layouts(); // validates layout options
+      options().r2r_kinds(); // validates r2r kinds
+      for(const auto& axes : options().axes())
+        axes_mask(axes, 3); // validates axes
+#ifndef USE_ESSL
+      if(!options().wisdom_cache().empty()) {
+        if(!native_fftw())
+          throw std::runtime_error("Wisdom cache is only supported by native fftw, unable to proceed");
+        options().wisdom_export_per_benchmark(); // validates option
+        if(compare_variants())
+          throw std::runtime_error("Wisdom cache cannot be used when comparing plan configurations, as wisdom is forgotten before each benchmark.");
+        const int nthreads = static_cast<int>(std::max<size_t>(1, used_threads()));
+        wisdom::Cache<float>::instance().open(options().wisdom_cache(), nthreads);
+        wisdom::Cache<double>::instance().open(options().wisdom_cache(), nthreads);
+      }
+#endif
+#if defined(GEARSHIFFT_BACKEND_FFTW_THREADS) && GEARSHIFFT_BACKEND_FFTW_THREADS==1 && !defined(_OPENMP)
+      // pooled pthread workers keep the FTZ/DAZ flags of the benchmark they were created in
+      if(options().getFtzDaz() == "both" && !fresh_planner() && used_threads() > 1)
+        std::cerr << "Warning: FFTW pthread workers keep their FTZ/DAZ flags, use --fresh-planner with --ftz-daz both."
+                  << std::endl;
+#endif
+      if(!fresh_planner()) {
+        // threaded solvers must be registered before wisdom is imported
+        init_planner<float>();
+        init_planner<double>();
+        import_wisdom<float>();
+        import_wisdom<double>();
+      }
+    }
+
+    /**
+     * Exports newly planned problems to wisdom cache and releases FFTW.
+     */
+    void destroy() {
+#ifndef USE_ESSL
+      try {
+        wisdom::Cache<float>::instance().save();
+        wisdom::Cache<double>::instance().save();
+      } catch(const std::runtime_error& e) {
+        std::cerr << "Warning: " << e.what() << std::endl;
+      }
+#endif
+      if(!fresh_planner()) {
+        cleanup_planner<float>();
+        cleanup_planner<double>();
+      }
+    }
+
+    std::string get_used_device_properties() {
+
+#if defined(GEARSHIFFT_BACKEND_FFTW_THREADS) && GEARSHIFFT_BACKEND_FFTW_THREADS==1
+      // Returns the number of supported concurrent threads of implementation
+      size_t maxndevs = std::thread::hardware_concurrency();
+      if(maxndevs==0)
+        maxndevs = 1;
 #else
       size_t maxndevs = 0;
-      size_t ndevs = 0;
 #endif
+      size_t ndevs = used_threads();
 
       std::ostringstream msg;
       msg << "\"SupportedThreads\"," << maxndevs
           << ",\"UsedThreads\"," << ndevs
           << ",\"TotalMemory\"," << getMemorySize()
+          << ",\"AvailableMemory\"," << getAvailableMemorySize()
           << ",\"PlanRigor\",\"" << options().plan_rigor_str();
       double plan_timelimit = options().plan_timelimit();
       if(plan_timelimit > 0.0)
         msg << "\",\"PlanTimeLimit [s]\"," << plan_timelimit;
       else
         msg << "\",\"PlanTimeLimit [s]\"," << "\"None\"";
+      msg << ",\"Planner\",\"" << (fresh_planner() ? "fresh" : "warm") << "\"";
+      if(options().autotune())
+        msg << ",\"Autotune\",\"on\"";
+#ifndef USE_ESSL
+      if(wisdom::Cache<float>::instance().enabled())
+        msg << ",\"WisdomCache\",\"" << options().wisdom_cache() << "\"";
+#endif
       return msg.str();
     }
 
   };
 
-  template<typename T_Precision>
-  struct ImportWisdom {
-
-    void operator()() {
-
-      if(!native_fftw())
-        throw std::runtime_error("Wisdom files are only supported by native fftw, unable to proceed");
-
-#ifndef USE_ESSL
-      std::string filename = FftwContext::options().wisdom_file<T_Precision>();
-      std::string source;
-      std::ifstream ifs;
-      std::stringstream ss;
-      std::string line;
-      ifs.open(filename.c_str(), std::ifstream::in);
-      if(!ifs.good())
-        throw std::runtime_error("Wisdom file not accessable.");
-
-      if(ifs.is_open()) {
-        while ( getline (ifs,line) )
-        {
-          ss << line;
-        }
-        ifs.close();
-        source = ss.str();
-      }
-
-      int imported = 0;
-      if(std::is_same<T_Precision,float>::value)
-        imported = fftwf_import_wisdom_from_string(source.c_str());
-      if(std::is_same<T_Precision,double>::value)
-        imported = fftw_import_wisdom_from_string(source.c_str());
-      if(!imported)
-        throw std::runtime_error("Wisdom file could not be loaded.");
-#endif
-    }
-
-  }; // FftwWisdomLoader
 
   /**
    * Fftw plan and execution class.
@@ -547,8 +1431,23 @@ namespace fftw {
     bool IsInplace = TFFT::IsInplace;
     static constexpr
     bool IsComplex = TFFT::IsComplex;
+    /// real-to-real transform (DCT/DST/DHT), input and output are real
     static constexpr
-    bool IsInplaceReal = IsInplace && !IsComplex;
+    bool IsR2R = is_r2r<TFFT>::value;
+    /// complex transform along a subset of the axes (--axes)
+    static constexpr
+    bool IsAxes = is_axes<TFFT>::value;
+    /// complex transform of split data (separate real and imaginary arrays)
+    static constexpr
+    bool IsSplit = is_split<TFFT>::value;
+    /// forward transform, pointwise multiply and inverse transform (--convolution)
+    static constexpr
+    bool IsConvolution = is_convolution<TFFT>::value;
+    static constexpr
+    bool IsInplaceReal = IsInplace && !IsComplex && !IsR2R;
+    /// buffers are allocated in host memory, see FFT::footprint()
+    static constexpr
+    bool UsesHostMemory = true;
 
     using value_type  = typename std::conditional<IsComplex,ComplexType,RealType>::type;
 
@@ -572,60 +1471,228 @@ namespace fftw {
     /// size in bytes of FFT(input) for out-of-place transforms
     size_t        data_complex_size_ = 0;
 
-    unsigned plan_rigor_ = FftwContext::options().plan_rigor();
+    /// number of rows (last dimension) of a transform
+    size_t rows_ = 0;
+    /// layout of data_ in elements: stride of the last dimension, row pitch and distance of transforms
+    size_t stride_ = 1;
+    size_t pitch_ = 0;
+    size_t dist_ = 0;
+    /// layout of data_complex_ in elements of ComplexType (RealType for R2R)
+    size_t pitch_complex_ = 0;
+    size_t dist_complex_ = 0;
+    /// number of transforms per plan
+    size_t batch_ = 1;
+    /// transformed axes of axis-wise transforms (bit mask, 0 = all)
+    unsigned axes_ = 0;
+    /// buffers hold dense arrays (apart from the in-place R2C padding)
+    bool dense_ = true;
+
+    /// rigor and planner flags
+    unsigned plan_rigor_ = FftwContext::plan_flags();
+    /// time limit in seconds of forward and inverse planning (<=0 = none)
+    double plan_budget_ = -1.0;
+    /// FFTW planner has been initialized for this instance (not by footprint())
+    bool planner_ = false;
+
+    FftwImpl(const Extent& cextents) : FftwImpl(cextents, LayoutOnly()) {
+        // memory requirements are checked against the memory budget by
+        // the BenchmarkExecutor before (UsesHostMemory)
+
+        // FFTW is initialized once by FftwContext::create()
+        if(FftwContext::fresh_planner()) {
+          FftwContext::init_planner<TPrecision>();
+          FftwContext::import_wisdom<TPrecision>();
+        }
+        planner_ = true;
+      }
+
+    ~FftwImpl(){
+
+      destroy();
+      if(!planner_)
+        return;
+#ifndef USE_ESSL
+      // a fresh planner forgets new wisdom by cleanup
+      if(wisdom_cache().enabled()
+         && (FftwContext::fresh_planner() || FftwContext::options().wisdom_export_per_benchmark())) {
+        try {
+          wisdom_cache().save();
+        } catch(const std::runtime_error& e) {
+          std::cerr << "Warning: " << e.what() << std::endl;
+        }
+      }
+#endif
+      if(FftwContext::fresh_planner())
+        FftwContext::cleanup_planner<TPrecision>();
+    }
+
+    /// buffer sizes of the selected layout without initializing the planner, see FFT::footprint()
+    static FFTFootprint footprint(const Extent& cextents) {
+      FftwImpl fft(cextents, LayoutOnly());
+      FFTFootprint fp;
+      fp.allocation = fft.get_allocation_size();
+      fp.transfer = fft.get_transfer_size();
+      return fp;
+    }
+
+  private:
+
+    struct LayoutOnly {};
 
-    FftwImpl(const Extent& cextents) {
+    /// layout of the buffers, FFTW is not initialized (see footprint())
+    FftwImpl(const Extent& cextents, LayoutOnly) {
         extents_ = interpret_as::column_major(cextents);
+        plan_budget_ = FftwContext::options().getPlanBudget(cextents);
+        if(plan_budget_ <= 0.0)
+          plan_budget_ = FftwContext::options().plan_timelimit();
         extents_complex_ = extents_;
 
+        // sizes are checked, as they are not limited to int by the guru64 interface
         n_ = std::accumulate(extents_.begin(),
                              extents_.end(),
-                             1,
-                             std::multiplies<std::size_t>());
+                             static_cast<size_t>(1),
+                             traits::checked_size);
 
-        if(!IsComplex){
+        if(!IsComplex && !IsR2R){
           extents_complex_.back() = (extents_.back()/2 + 1);
         }
 
         n_complex_ = std::accumulate(extents_complex_.begin(),
                                      extents_complex_.end(),
-                                     1,
-                                     std::multiplies<size_t>());
+                                     static_cast<size_t>(1),
+                                     traits::checked_size);
+
+        // layout of the buffers, rows are strided and padded, transforms of a batch
+        // follow each other (in-place R2C: real row holds a padded complex row)
+        const auto& config = FftwContext::selected();
+        stride_ = config.stride;
+        batch_ = config.batch;
+        dense_ = stride_ == 1 && config.pad == 0 && batch_ == 1;
+        if(IsAxes) {
+          axes_ = FftwContext::axes_mask(config.axes, NDim);
+          if(axes_ == 0)
+            throw std::runtime_error("No valid axes selected for axis-wise transform.");
+        }
+#ifdef USE_ESSL
+        if(!dense_)
+          throw std::runtime_error("Strided, padded and batched layouts are not supported by the ESSL wrappers.");
+#endif
+        rows_ = n_ / extents_.back();
+        pitch_complex_ = traits::checked_size(stride_, extents_complex_.back()) + config.pad;
+        dist_complex_ = traits::checked_size(pitch_complex_, rows_) + config.batch_pad;
+        if(IsInplaceReal) {
+          pitch_ = 2*pitch_complex_;
+          dist_ = traits::checked_size(dist_complex_, 2);
+        } else {
+          pitch_ = traits::checked_size(stride_, extents_.back()) + config.pad;
+          dist_ = traits::checked_size(pitch_, rows_) + config.batch_pad;
+        }
 
-        data_size_ = (IsInplaceReal ? 2*n_complex_ : n_) * sizeof(value_type);
+        data_size_ = traits::checked_size(buffer_length(pitch_, dist_), sizeof(value_type));
         if(!IsInplace)
-          data_complex_size_ = n_complex_ * sizeof(ComplexType);
-
-        //size_t total_mem = getMemorySize();
-        size_t total_mem = 95*getMemorySize()/100; // keep some memory available, otherwise an out-of-memory killer becomes more likely
-        if(total_mem < 3*data_size_+data_complex_size_) { // includes host input buffers
-          std::stringstream ss;
-          ss << total_mem << "<" << 3*data_size_+data_complex_size_ << " (bytes)";
-          throw std::runtime_error("FFT data exceeds physical memory. "+ss.str());
-        }
+          data_complex_size_ = traits::checked_size(buffer_length(pitch_complex_, dist_complex_),
+                                                    IsR2R ? sizeof(RealType) : sizeof(ComplexType));
+      }
 
-#if defined(GEARSHIFFT_BACKEND_FFTW_THREADS) && GEARSHIFFT_BACKEND_FFTW_THREADS==1
-        if( traits::thread_api<TPrecision>::init_threads()==0 )
-          throw std::runtime_error("fftw thread initialization failed.");
+  public:
 
-        traits::thread_api<TPrecision>::plan_with_threads(FftwContext::options().getNumberDevices());
+    /**
+     * R2R, axis-wise and split benchmarks are only run with --r2r, --axes or --split and native FFTW,
+     * convolution benchmarks with --convolution.
+     */
+    static bool enabled() {
+      if(IsConvolution)
+        return FftwContext::options().getConvolution();
+      if(!IsR2R && !IsAxes && !IsSplit)
+        return true;
+#ifndef USE_ESSL
+      if(IsSplit)
+        return native_fftw() && FftwContext::options().split();
+      return native_fftw() && !kind_variants().empty();
+#else
+      return false;
 #endif
+    }
 
+    /**
+     * Scaling of the unnormalized round trip, logical size for R2R transforms,
+     * product of the transformed extents for axis-wise transforms.
+     */
+    static double normalization(const Extent& cextents) {
+      double norm = 1.0;
 #ifndef USE_ESSL
-        if(plan_rigor_ == FFTW_WISDOM_ONLY && native_fftw()) {
-          ImportWisdom<TPrecision>()();
-        }
+      if(IsR2R) {
+        const auto kind = traits::r2r_kind_by_name(FftwContext::r2r_kind());
+        for(auto n : cextents)
+          norm *= static_cast<double>(traits::r2r_logical_size(kind, n));
+        return norm;
+      }
 #endif
+      const unsigned axes = IsAxes ? FftwContext::axes_mask(FftwContext::selected().axes, NDim) : 0;
+      for(size_t i = 0; i < NDim; ++i) {
+        if(axes == 0 || (axes & (1u << i)))
+          norm *= static_cast<double>(cextents[i]);
       }
+      return norm;
+    }
 
-    ~FftwImpl(){
-
-      destroy();
-#if defined(GEARSHIFFT_BACKEND_FFTW_THREADS) && GEARSHIFFT_BACKEND_FFTW_THREADS==1
-      traits::thread_api<TPrecision>::cleanup_threads();
+    /// REDFT00 (DCT-I) is not defined for a single point (logical size 0)
+    static std::string unsupported(const Extent& cextents) {
+#ifndef USE_ESSL
+      if(IsR2R && FftwContext::r2r_kind() == "redft00") {
+        for(auto n : cextents) {
+          if(n < 2)
+            return "redft00 needs at least 2 points per axis";
+        }
+      }
 #else
-      traits::no_thread_api<TPrecision>::cleanup();
+      gearshifft::ignore_unused(cextents);
 #endif
+      return "";
+    }
+
+    /**
+     * Plan configurations to be compared, see FftwContext::variants().
+     * R2R benchmarks are run for each kind of --r2r ("r2r=<kind>"),
+     * axis-wise benchmarks for each axis set of --axes ("axes=<axes>").
+     */
+    static std::vector<std::string> variants() {
+      auto configs = FftwContext::variants(IsInplace);
+      if(!IsR2R && !IsAxes)
+        return configs;
+      std::vector<std::string> result;
+      for(const auto& kind : kind_variants()) {
+        if(configs.empty())
+          result.push_back(kind);
+        for(const auto& config : configs)
+          result.push_back(kind + ";" + config);
+      }
+      return result;
+    }
+
+    /// selects plan configuration of the next instances
+    static void select_variant(const std::string& variant) {
+      FftwContext::select_variant(variant);
+    }
+
+    /// plan configurations of the same R2R kind and layout are compared
+    static std::string variant_group(const std::string& variant) {
+      return FftwContext::variant_group(variant);
+    }
+
+    /// leading-dimension padding of the variant is swept (--pad-sweep)
+    static std::string variant_sweep(const std::string& variant) {
+      return FftwContext::variant_sweep(variant);
+    }
+
+    /// number of plans of this benchmark created from wisdom
+    size_t get_plan_cache_hits() const {
+      return plan_cache_hits_;
+    }
+
+    /// number of plans of this benchmark not found in wisdom
+    size_t get_plan_cache_misses() const {
+      return plan_cache_misses_;
     }
 
     /**
@@ -635,15 +1702,30 @@ namespace fftw {
       return data_size_ + data_complex_size_;
     }
 
+    /// spectrum of the forward transform (host memory), multiplied by the convolution benchmarks
+    ComplexType* get_spectrum() {
+      return data_complex_;
+    }
+
+    /// complex values of the spectrum buffer, including the gaps of strided and padded layouts
+    size_t get_spectrum_size() {
+      return (IsInplace ? data_size_ : data_complex_size_) / sizeof(ComplexType);
+    }
+
     // create FFT plan handle
     void init_forward() {
 
+#ifndef USE_ESSL
+      // plan configurations are measured without wisdom of previous plans
+      if(FftwContext::compare_variants())
+        traits::wisdom_api<TPrecision>::forget();
+#endif
+      plan_timer_.startTimer();
+
       //Note: these calls clear the content of data_ et al
-      fwd_plan_ = PlanAPI::create(extents_,
-                                  data_,
-                                  data_complex_,
-                                  traits::fftw_direction::forward,
-                                  plan_rigor_);
+      fwd_plan_ = create_plan(data_,
+                              data_complex_,
+                              traits::fftw_direction::forward);
       if(!fwd_plan_) {
 #ifndef USE_ESSL
         if(plan_rigor_ == FFTW_WISDOM_ONLY) {
@@ -658,11 +1740,9 @@ namespace fftw {
 
     //
     void init_inverse() {
-      bwd_plan_ = PlanAPI::create(extents_,
-                                  data_complex_,
-                                  data_,
-                                  traits::fftw_direction::inverse,
-                                  plan_rigor_);
+      bwd_plan_ = create_plan(data_complex_,
+                              data_,
+                              traits::fftw_direction::inverse);
       if(!bwd_plan_) {
 #ifndef USE_ESSL
         if(plan_rigor_ == FFTW_WISDOM_ONLY) {
@@ -689,11 +1769,12 @@ namespace fftw {
      * Returns size in bytes of one data transfer.
      *
      * Upload and download have the same size due to round-trip FFT.
+     * Transforms of a batch get the same data, the size refers to one transform.
      * \return Size in bytes of FFT data to be transferred (to device or to host memory buffer).
      */
     size_t get_transfer_size() {
-      // when inplace-real then alloc'd data is bigger than data to be transferred
-      return IsInplaceReal ? n_*sizeof(RealType) : data_size_;
+      // when inplace-real or strided then alloc'd data is bigger than data to be transferred
+      return n_*sizeof(value_type);
     }
 
     //////////////////////////////////////////////////////////////////////////////////////
@@ -718,59 +1799,221 @@ namespace fftw {
       PlanAPI::execute(bwd_plan_);
     }
 
+    /// copies the input to every transform of the batch
     template<typename THostData>
     void upload(THostData* input) {
 
-      if(!IsInplaceReal){
+      if(IsSplit){
+        for(std::size_t b = 0; b < batch_; ++b)
+          split_rows<true>(b, reinterpret_cast<RealType*>(input));
+      } else if(dense_ && !IsInplaceReal){
         MemoryAPI::memcpy(data_, input, data_size_);
       } else {
-        const std::size_t max_z = (NDim >= 3 ? extents_[NDim-3] : 1);
-        const std::size_t max_y = (NDim >= 2 ? extents_[NDim-2] : 1);
-        const std::size_t max_x = extents_[NDim-1];
-        const std::size_t allocated_x = 2*(extents_[NDim-1]/2+1);
-
-        std::size_t input_index = 0;
-        std::size_t data_index = 0;
-
-        for(std::size_t z = 0;z < max_z;++z){
-          for(std::size_t y = 0;y < max_y;++y){
-            input_index = z*(max_y*max_x) + y*max_x;
-            data_index = z*(max_y*allocated_x) + y*allocated_x;
-            MemoryAPI::memcpy(data_ + data_index,
-                              input + input_index,
-                              max_x * sizeof(value_type));
-          }
-        }
+        for(std::size_t b = 0; b < batch_; ++b)
+          copy_rows<true>(data_ + b*dist_, input);
       }
     }
 
+    /// copies the result of the first transform of the batch
     template<typename THostData>
     void download(THostData* output) {
 
-      if(!IsInplaceReal){
+      if(IsSplit){
+        split_rows<false>(0, reinterpret_cast<RealType*>(output));
+      } else if(dense_ && !IsInplaceReal){
         MemoryAPI::memcpy(output, data_, data_size_);
       } else {
-        const std::size_t max_z = (NDim >= 3 ? extents_[NDim-3] : 1);
-        const std::size_t max_y = (NDim >= 2 ? extents_[NDim-2] : 1);
-        const std::size_t max_x = extents_[NDim-1];
-        const std::size_t allocated_x = 2*(extents_[NDim-1]/2+1);
-
-        std::size_t output_index = 0;
-        std::size_t data_index = 0;
-
-        for(std::size_t z = 0;z < max_z;++z){
-          for(std::size_t y = 0;y < max_y;++y){
-            output_index = z*(max_y*max_x) + y*max_x;
-            data_index = z*(max_y*allocated_x) + y*allocated_x;
-            MemoryAPI::memcpy(output+output_index,
-                              data_ + data_index,
-                              max_x * sizeof(value_type));
+        copy_rows<false>(output, static_cast<const value_type*>(data_));
+      }
+    }
+
+  private:
+
+    /// variant labels of the transform kinds selected by --r2r or --axes
+    static std::vector<std::string> kind_variants() {
+      std::vector<std::string> result;
+      if(IsR2R) {
+        for(const auto& kind : FftwContext::options().r2r_kinds())
+          result.push_back("r2r=" + kind);
+      }
+      if(IsAxes && NDim > 1) {
+        for(const auto& axes : FftwContext::options().axes()) {
+          if(FftwContext::axes_exist(axes, NDim))
+            result.push_back("axes=" + axes);
+        }
+      }
+      return result;
+    }
+
+    /// number of elements of a buffer with the given row pitch and distance of transforms
+    size_t buffer_length(size_t pitch, size_t dist) const {
+      return traits::checked_size(dist, batch_-1) + traits::checked_size(pitch, rows_);
+    }
+
+    /// element-wise (strided) or row-wise copy between the dense host array and data_
+    template<bool ToData, typename TDst, typename TSrc>
+    void copy_rows(TDst* dst, const TSrc* src) {
+      const bool to_data = ToData;
+      const std::size_t max_x = extents_[NDim-1];
+      for(std::size_t row = 0; row < rows_; ++row) {
+        const std::size_t host_index = row*max_x;
+        const std::size_t data_index = row*pitch_;
+        TDst* d = dst + (to_data ? data_index : host_index);
+        const TSrc* s = src + (to_data ? host_index : data_index);
+        if(stride_ == 1) {
+          MemoryAPI::memcpy(d, s, max_x * sizeof(value_type));
+        } else {
+          for(std::size_t x = 0; x < max_x; ++x)
+            MemoryAPI::memcpy(d + (to_data ? x*stride_ : x),
+                              s + (to_data ? x : x*stride_),
+                              sizeof(value_type));
+        }
+      }
+    }
+
+    /// number of elements of the real and the imaginary array of a split buffer
+    size_t split_length() const {
+      return buffer_length(pitch_, dist_);
+    }
+
+    /// (de-)interleaves rows of transform b between the interleaved host array and split data_
+    template<bool ToData>
+    void split_rows(std::size_t b, RealType* host) {
+      RealType* re = reinterpret_cast<RealType*>(data_);
+      RealType* im = re + split_length();
+      const std::size_t max_x = extents_[NDim-1];
+      for(std::size_t row = 0; row < rows_; ++row) {
+        const std::size_t data_index = b*dist_ + row*pitch_;
+        const std::size_t host_index = 2*row*max_x;
+        for(std::size_t x = 0; x < max_x; ++x) {
+          const std::size_t i = data_index + x*stride_;
+          if(ToData) {
+            re[i] = host[host_index + 2*x];
+            im[i] = host[host_index + 2*x + 1];
+          } else {
+            host[host_index + 2*x] = re[i];
+            host[host_index + 2*x + 1] = im[i];
           }
         }
       }
+    }
 
+    /// layout of the forward (real/input to complex) or inverse plan
+    traits::layout plan_layout(traits::fftw_direction dir) const {
+      traits::layout layout;
+      layout.in_stride = stride_;
+      layout.out_stride = stride_;
+      layout.in_pitch = pitch_;
+      layout.out_pitch = pitch_complex_;
+      layout.howmany = batch_;
+      layout.in_dist = dist_;
+      layout.out_dist = dist_complex_;
+      layout.axes = axes_;
+      if(dir == traits::fftw_direction::inverse) {
+        std::swap(layout.in_pitch, layout.out_pitch);
+        std::swap(layout.in_dist, layout.out_dist);
+      }
+      return layout;
     }
 
+#ifndef USE_ESSL
+    static wisdom::Cache<TPrecision>& wisdom_cache() {
+      return wisdom::Cache<TPrecision>::instance();
+    }
+#endif
+
+    /**
+     * Creates plan, with wisdom cache a plan is tried from wisdom first
+     * to count hits and misses.
+     */
+    template<typename TIn, typename TOut>
+    PlanType create_plan(TIn* in, TOut* out, traits::fftw_direction dir) {
+#if defined(GEARSHIFFT_BACKEND_FFTW_THREADS) && GEARSHIFFT_BACKEND_FFTW_THREADS==1
+      traits::thread_api<TPrecision>::plan_with_threads(static_cast<int>(FftwContext::plan_threads()));
+#endif
+      set_timelimit();
+#ifndef USE_ESSL
+      if(wisdom_cache().enabled() || plan_rigor_ == FFTW_WISDOM_ONLY) {
+        PlanType plan = plan_create(in, out, dir, plan_rigor_ | FFTW_WISDOM_ONLY, PlanKind());
+        if(plan) {
+          ++plan_cache_hits_;
+          if(wisdom_cache().enabled())
+            wisdom_cache().hit();
+          return plan;
+        }
+        ++plan_cache_misses_;
+        if(plan_rigor_ == FFTW_WISDOM_ONLY)
+          return nullptr;
+        wisdom_cache().miss();
+      }
+#endif
+      return plan_create(in, out, dir, plan_rigor_, PlanKind());
+    }
+
+    /// planner interface of the FFT kind: 0 = dft/r2c/c2r, 1 = r2r, 2 = split dft
+    using PlanKind = std::integral_constant<int, IsR2R ? 1 : (IsSplit ? 2 : 0)>;
+
+    template<typename TIn, typename TOut>
+    PlanType plan_create(TIn* in, TOut* out, traits::fftw_direction dir, unsigned flags, std::integral_constant<int, 0>) {
+      return PlanAPI::create(extents_, in, out, dir, flags, plan_layout(dir));
+    }
+
+    /// R2R: complex buffer of the out-of-place transform holds real data
+    template<typename TIn, typename TOut>
+    PlanType plan_create(TIn* in, TOut* out, traits::fftw_direction dir, unsigned flags, std::integral_constant<int, 1>) {
+#ifndef USE_ESSL
+      const auto kind = traits::r2r_kind_by_name(FftwContext::r2r_kind());
+      return PlanAPI::create_r2r(extents_,
+                                 reinterpret_cast<RealType*>(in),
+                                 reinterpret_cast<RealType*>(out),
+                                 dir == traits::fftw_direction::forward ? kind : traits::r2r_inverse(kind),
+                                 flags,
+                                 plan_layout(dir));
+#else
+      gearshifft::ignore_unused(in, out, dir, flags);
+      throw std::runtime_error("Real-to-real transforms are not supported by the ESSL wrappers.");
+#endif
+    }
+
+    /// split: buffers hold the real array followed by the imaginary array
+    template<typename TIn, typename TOut>
+    PlanType plan_create(TIn* in, TOut* out, traits::fftw_direction dir, unsigned flags, std::integral_constant<int, 2>) {
+#ifndef USE_ESSL
+      RealType* ri = reinterpret_cast<RealType*>(in);
+      RealType* ii = ri + split_length();
+      RealType* ro = reinterpret_cast<RealType*>(out);
+      RealType* io = ro + split_length();
+      if(dir == traits::fftw_direction::inverse) {
+        std::swap(ri, ii);
+        std::swap(ro, io);
+      }
+      return PlanAPI::create_split(extents_, ri, ii, ro, io, flags, plan_layout(dir));
+#else
+      gearshifft::ignore_unused(in, out, dir, flags);
+      throw std::runtime_error("Split-complex transforms are not supported by the ESSL wrappers.");
+#endif
+    }
+
+    /**
+     * Forward and inverse plan share the planning budget, the inverse plan
+     * gets what is left after the forward plan.
+     */
+    void set_timelimit() {
+      double timelimit = FFTW_NO_TIMELIMIT;
+      if(plan_budget_ > 0.0) {
+        const double elapsed = fwd_plan_ ? plan_timer_.stopTimer()/1000.0 : 0.0;
+        // FFTW treats limits <= 0 as unlimited
+        timelimit = std::max(plan_budget_ - elapsed, 1e-6);
+      }
+      traits::no_thread_api<TPrecision>::set_timelimit(timelimit);
+    }
+
+    size_t plan_cache_hits_ = 0;
+    size_t plan_cache_misses_ = 0;
+    TimerCPU plan_timer_;
+
+  public:
+
     void destroy() {
 
       if(data_)
@@ -811,6 +2054,56 @@ namespace fftw {
                                            FFT_Plan_Not_Reusable,
                                            FftwImpl,
                                            TimerCPU>;
+
+  using Inplace_Convolution_Real = gearshifft::FFT<FFT_Inplace_Convolution_Real,
+                                                   FFT_Plan_Not_Reusable,
+                                                   FftwImpl,
+                                                   TimerCPU>;
+
+  using Outplace_Convolution_Real = gearshifft::FFT<FFT_Outplace_Convolution_Real,
+                                                    FFT_Plan_Not_Reusable,
+                                                    FftwImpl,
+                                                    TimerCPU>;
+
+  using Inplace_Convolution_Complex = gearshifft::FFT<FFT_Inplace_Convolution_Complex,
+                                                      FFT_Plan_Not_Reusable,
+                                                      FftwImpl,
+                                                      TimerCPU>;
+
+  using Outplace_Convolution_Complex = gearshifft::FFT<FFT_Outplace_Convolution_Complex,
+                                                       FFT_Plan_Not_Reusable,
+                                                       FftwImpl,
+                                                       TimerCPU>;
+
+  using Inplace_Axes_Complex = gearshifft::FFT<FFT_Inplace_Axes_Complex,
+                                               FFT_Plan_Not_Reusable,
+                                               FftwImpl,
+                                               TimerCPU>;
+
+  using Outplace_Axes_Complex = gearshifft::FFT<FFT_Outplace_Axes_Complex,
+                                                FFT_Plan_Not_Reusable,
+                                                FftwImpl,
+                                                TimerCPU>;
+
+  using Inplace_Split_Complex = gearshifft::FFT<FFT_Inplace_Split_Complex,
+                                                FFT_Plan_Not_Reusable,
+                                                FftwImpl,
+                                                TimerCPU>;
+
+  using Outplace_Split_Complex = gearshifft::FFT<FFT_Outplace_Split_Complex,
+                                                 FFT_Plan_Not_Reusable,
+                                                 FftwImpl,
+                                                 TimerCPU>;
+
+  using Inplace_R2R = gearshifft::FFT<FFT_Inplace_R2R,
+                                      FFT_Plan_Not_Reusable,
+                                      FftwImpl,
+                                      TimerCPU>;
+
+  using Outplace_R2R = gearshifft::FFT<FFT_Outplace_R2R,
+                                       FFT_Plan_Not_Reusable,
+                                       FftwImpl,
+                                       TimerCPU>;
 } // namespace fftw
 } // namespace gearshifft
 
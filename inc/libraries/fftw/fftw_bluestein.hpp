@@ -0,0 +1,401 @@
+#ifndef FFTW_BLUESTEIN_HPP_
+#define FFTW_BLUESTEIN_HPP_
+
+#include "fftw.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace gearshifft {
+namespace fftw {
+
+  /**
+   * Bluestein's algorithm (chirp-z transform): a DFT of size n is a circular
+   * convolution of size m >= 2n-1, which is computed by FFTs of power-of-two
+   * size m. With the chirp w_j = exp(sign*pi*i*j^2/n) the DFT is
+   * X_k = w_k * sum_j (x_j*w_j) * conj(w_{k-j}).
+   */
+  namespace bluestein {
+
+    /// complex product without the NaN/Inf checks of std::complex (__mulsc3), so the loops vectorize
+    template<typename T>
+    inline std::complex<T> mul(const std::complex<T>& a, const std::complex<T>& b) {
+      return std::complex<T>(a.real()*b.real() - a.imag()*b.imag(),
+                             a.real()*b.imag() + a.imag()*b.real());
+    }
+
+    inline bool is_pow2(size_t n) {
+      return n > 0 && (n & (n-1)) == 0;
+    }
+
+    /// size of the convolution, n itself for powers of two (no convolution)
+    inline size_t convolution_size(size_t n) {
+      if(is_pow2(n))
+        return n;
+      size_t m = 1;
+      while(m < 2*n-1)
+        m <<= 1;
+      return m;
+    }
+
+    /**
+     * Chirp of size n and sign, and the spectrum of the convolution kernel
+     * conj(w_{|l|}), which is scaled by 1/m for the unnormalized inverse FFT.
+     */
+    template<typename T>
+    struct Chirp {
+      using PlanAPI = typename traits::plan<T>;
+      using ComplexType = typename traits::plan<T>::ComplexType;
+
+      size_t n;
+      size_t m;
+      std::vector<std::complex<T> > chirp;
+      std::vector<std::complex<T> > spectrum;
+
+      Chirp(size_t _n, int sign) : n(_n), m(convolution_size(_n)), chirp(_n), spectrum(m) {
+        const long double pi = 3.141592653589793238462643383279502884L;
+        // j^2 mod 2n keeps the angles small, exp(pi*i*j^2/n) has period 2n in j^2
+        size_t q = 0;
+        for(size_t j = 0; j < n; ++j) {
+          const long double phi = sign * pi * static_cast<long double>(q) / static_cast<long double>(n);
+          chirp[j] = std::complex<T>(static_cast<T>(std::cos(phi)), static_cast<T>(std::sin(phi)));
+          q = (q + 2*j + 1) % (2*n);
+        }
+        const T scale = static_cast<T>(1) / static_cast<T>(m);
+        spectrum[0] = std::conj(chirp[0]) * scale;
+        for(size_t j = 1; j < n; ++j)
+          spectrum[j] = spectrum[m-j] = std::conj(chirp[j]) * scale;
+
+        auto data = reinterpret_cast<ComplexType*>(spectrum.data());
+        auto plan = PlanAPI::create(std::array<size_t, 1>{{m}}, data, data,
+                                    traits::fftw_direction::forward, FFTW_ESTIMATE);
+        if(!plan)
+          throw std::runtime_error("fftw plan of the Bluestein chirp spectrum could not be created.");
+        PlanAPI::execute(plan);
+        PlanAPI::destroy(plan);
+      }
+    };
+
+    /// chirps and spectra of all benchmarks, computed once per size and sign
+    template<typename T>
+    class ChirpCache {
+    public:
+      static ChirpCache& instance() {
+        static ChirpCache cache;
+        return cache;
+      }
+
+      /// returns the chirp of size n, hit is true if it has been computed before
+      std::shared_ptr<const Chirp<T> > get(size_t n, int sign, bool& hit) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& entry = chirps_[std::make_pair(n, sign)];
+        hit = static_cast<bool>(entry);
+        if(!hit)
+          entry = std::make_shared<const Chirp<T> >(n, sign);
+        return entry;
+      }
+
+    private:
+      std::mutex mutex_;
+      std::map<std::pair<size_t, int>, std::shared_ptr<const Chirp<T> > > chirps_;
+    };
+
+  } // namespace bluestein
+
+  /**
+   * Complex FFTs of any size by Bluestein's algorithm on top of FFTW, which
+   * computes the convolutions of power-of-two size. The dimensions are
+   * transformed one after another by batches of 1D FFTs (lines gathered into
+   * a work buffer), power-of-two extents are transformed without convolution.
+   * Run with --bluestein to compare against the native FFTW benchmarks.
+   */
+  template<typename TFFT, // FFT_Inplace_Bluestein_Complex or FFT_Outplace_Bluestein_Complex
+           typename TPrecision, // double, float
+           size_t   NDim // 1..3
+           >
+  struct FftwBluesteinImpl
+  {
+    using Extent = std::array<std::size_t, NDim>;
+    using PlanAPI = typename traits::plan<TPrecision>;
+    using ComplexType = typename traits::plan<TPrecision>::ComplexType;
+    using RealType = typename traits::plan<TPrecision>::RealType;
+    using PlanType = typename traits::plan<TPrecision>::PlanType;
+    using MemoryAPI = typename traits::memory_api<TPrecision>;
+    using Chirp = bluestein::Chirp<TPrecision>;
+    using Value = std::complex<RealType>;
+
+    static_assert(TFFT::IsComplex, "Bluestein benchmarks are complex transforms only.");
+
+    static constexpr bool IsInplace = TFFT::IsInplace;
+    static constexpr bool UsesHostMemory = true;
+
+    Extent extents_ = {{0}};
+    /// convolution sizes
+    Extent conv_ = {{0}};
+    size_t n_ = 0;
+    /// elements of the work buffer, the largest batch of padded lines
+    size_t work_size_ = 0;
+
+    ComplexType* data_ = nullptr;
+    ComplexType* data_complex_ = nullptr;
+    ComplexType* work_ = nullptr;
+
+    /// forward and backward FFTs of the padded lines of each dimension
+    std::array<PlanType, NDim> fwd_plans_ = {{nullptr}};
+    std::array<PlanType, NDim> bwd_plans_ = {{nullptr}};
+    std::array<std::shared_ptr<const Chirp>, NDim> fwd_chirps_;
+    std::array<std::shared_ptr<const Chirp>, NDim> bwd_chirps_;
+
+    size_t chirp_hits_ = 0;
+    size_t chirp_misses_ = 0;
+
+    FftwBluesteinImpl(const Extent& cextents) {
+      extents_ = interpret_as::column_major(cextents);
+      n_ = std::accumulate(extents_.begin(),
+                           extents_.end(),
+                           static_cast<size_t>(1),
+                           traits::checked_size);
+      for(size_t d = 0; d < NDim; ++d) {
+        conv_[d] = bluestein::convolution_size(extents_[d]);
+        work_size_ = std::max(work_size_, traits::checked_size(n_/extents_[d], conv_[d]));
+      }
+
+      if(FftwContext::fresh_planner())
+        FftwContext::init_planner<TPrecision>();
+    }
+
+    ~FftwBluesteinImpl() {
+      destroy();
+      if(FftwContext::fresh_planner())
+        FftwContext::cleanup_planner<TPrecision>();
+    }
+
+    /// Bluestein benchmarks are only run with --bluestein and native FFTW
+    static bool enabled() {
+      return native_fftw() && FftwContext::options().bluestein();
+    }
+
+    /// plan configurations of the convolution FFTs (--rigor list, --autotune)
+    static std::vector<std::string> variants() {
+      return FftwContext::plan_configs(IsInplace);
+    }
+
+    static void select_variant(const std::string& variant) {
+      FftwContext::select_variant(variant);
+    }
+
+    /// number of chirps of this benchmark taken from the chirp cache
+    size_t get_chirp_cache_hits() const {
+      return chirp_hits_;
+    }
+
+    /// number of chirps of this benchmark computed by the plan initialization
+    size_t get_chirp_cache_misses() const {
+      return chirp_misses_;
+    }
+
+    /// data buffers and work buffer of the padded lines, see FFT::footprint()
+    static FFTFootprint footprint(const Extent& cextents) {
+      const size_t n = std::accumulate(cextents.begin(),
+                                       cextents.end(),
+                                       static_cast<size_t>(1),
+                                       traits::checked_size);
+      size_t work_size = 0;
+      for(size_t d = 0; d < NDim; ++d)
+        work_size = std::max(work_size, traits::checked_size(n/cextents[d], bluestein::convolution_size(cextents[d])));
+      FFTFootprint fp;
+      fp.allocation = ((IsInplace ? 1 : 2) * n + work_size) * sizeof(ComplexType);
+      fp.transfer = n * sizeof(ComplexType);
+      return fp;
+    }
+
+    size_t get_allocation_size() {
+      return (IsInplace ? 1 : 2) * n_ * sizeof(ComplexType) + work_size_ * sizeof(ComplexType);
+    }
+
+    /// chirps and kernel spectra of both directions (FFTW plans are not accounted)
+    size_t get_plan_size() {
+      size_t size = 0;
+      for(size_t d = 0; d < NDim; ++d) {
+        if(!bluestein::is_pow2(extents_[d]))
+          size += 2 * (extents_[d] + conv_[d]) * sizeof(ComplexType);
+      }
+      return size;
+    }
+
+    size_t get_transfer_size() {
+      return n_ * sizeof(ComplexType);
+    }
+
+    /// FFTW plans of the padded lines, which are used by both directions
+    void init_forward() {
+      const unsigned flags = FftwContext::plan_flags();
+      FftwContext::prepare_plans<TPrecision>();
+      for(size_t d = 0; d < NDim; ++d) {
+        traits::layout lines;
+        lines.howmany = n_ / extents_[d];
+        lines.in_dist = conv_[d];
+        lines.out_dist = conv_[d];
+        const std::array<size_t, 1> shape = {{conv_[d]}};
+        fwd_plans_[d] = PlanAPI::create(shape, work_, work_, traits::fftw_direction::forward, flags, lines);
+        bwd_plans_[d] = PlanAPI::create(shape, work_, work_, traits::fftw_direction::inverse, flags, lines);
+        if(!fwd_plans_[d] || !bwd_plans_[d])
+          throw std::runtime_error("fftw plan of the Bluestein convolution could not be created.");
+      }
+      fetch_chirps(fwd_chirps_, -1);
+    }
+
+    void init_inverse() {
+      fetch_chirps(bwd_chirps_, 1);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    // --- next methods are benchmarked ---
+
+    void allocate() {
+      data_ = static_cast<ComplexType*>(MemoryAPI::malloc(n_ * sizeof(ComplexType)));
+      data_complex_ = IsInplace ? data_
+                                : static_cast<ComplexType*>(MemoryAPI::malloc(n_ * sizeof(ComplexType)));
+      work_ = static_cast<ComplexType*>(MemoryAPI::malloc(work_size_ * sizeof(ComplexType)));
+    }
+
+    void execute_forward() {
+      for(size_t d = 0; d < NDim; ++d)
+        execute_dim(d, d == 0 ? data_ : data_complex_, data_complex_, fwd_chirps_[d].get(), true);
+    }
+
+    void execute_inverse() {
+      for(size_t d = 0; d < NDim; ++d)
+        execute_dim(d, d == 0 ? data_complex_ : data_, data_, bwd_chirps_[d].get(), false);
+    }
+
+    template<typename THostData>
+    void upload(THostData* input) {
+      MemoryAPI::memcpy(data_, input, n_ * sizeof(ComplexType));
+    }
+
+    template<typename THostData>
+    void download(THostData* output) {
+      MemoryAPI::memcpy(output, data_, n_ * sizeof(ComplexType));
+    }
+
+    void destroy() {
+      for(size_t d = 0; d < NDim; ++d) {
+        if(fwd_plans_[d])
+          PlanAPI::destroy(fwd_plans_[d]);
+        fwd_plans_[d] = nullptr;
+        if(bwd_plans_[d])
+          PlanAPI::destroy(bwd_plans_[d]);
+        bwd_plans_[d] = nullptr;
+      }
+
+      if(data_complex_ && !IsInplace)
+        MemoryAPI::free(data_complex_);
+      data_complex_ = nullptr;
+
+      if(data_)
+        MemoryAPI::free(data_);
+      data_ = nullptr;
+
+      if(work_)
+        MemoryAPI::free(work_);
+      work_ = nullptr;
+    }
+
+  private:
+
+    /// chirps of the non-power-of-two extents from the chirp cache
+    void fetch_chirps(std::array<std::shared_ptr<const Chirp>, NDim>& chirps, int sign) {
+      for(size_t d = 0; d < NDim; ++d) {
+        if(bluestein::is_pow2(extents_[d]))
+          continue;
+        bool hit = false;
+        chirps[d] = bluestein::ChirpCache<TPrecision>::instance().get(extents_[d], sign, hit);
+        ++(hit ? chirp_hits_ : chirp_misses_);
+      }
+    }
+
+    /**
+     * Transforms dimension d from src to dst (may be the same array), element j
+     * of line (o, c) is at (o*n + j)*inner + c. Without chirp (power of two)
+     * the lines are transformed directly by the forward or backward FFT.
+     */
+    void execute_dim(size_t d, const ComplexType* src, ComplexType* dst, const Chirp* chirp, bool forward) {
+      const size_t n = extents_[d];
+      const size_t m = conv_[d];
+      size_t inner = 1;
+      for(size_t i = d+1; i < NDim; ++i)
+        inner *= extents_[i];
+      const size_t outer = n_ / (n * inner);
+      const Value* x = reinterpret_cast<const Value*>(src);
+      Value* y = reinterpret_cast<Value*>(dst);
+      Value* work = reinterpret_cast<Value*>(work_);
+
+      for(size_t o = 0; o < outer; ++o) {
+        for(size_t c = 0; c < inner; ++c) {
+          Value* line = work + (o*inner + c)*m;
+          const Value* in = x + o*n*inner + c;
+          if(chirp) {
+            for(size_t j = 0; j < n; ++j)
+              line[j] = bluestein::mul(in[j*inner], chirp->chirp[j]);
+            std::fill(line + n, line + m, Value(0));
+          } else {
+            for(size_t j = 0; j < n; ++j)
+              line[j] = in[j*inner];
+          }
+        }
+      }
+
+      if(chirp) {
+        PlanAPI::execute(fwd_plans_[d]);
+        const Value* spectrum = chirp->spectrum.data();
+        for(size_t l = 0; l < outer*inner; ++l) {
+          Value* line = work + l*m;
+          for(size_t k = 0; k < m; ++k)
+            line[k] = bluestein::mul(line[k], spectrum[k]);
+        }
+        PlanAPI::execute(bwd_plans_[d]);
+      } else {
+        PlanAPI::execute(forward ? fwd_plans_[d] : bwd_plans_[d]);
+      }
+
+      for(size_t o = 0; o < outer; ++o) {
+        for(size_t c = 0; c < inner; ++c) {
+          const Value* line = work + (o*inner + c)*m;
+          Value* out = y + o*n*inner + c;
+          if(chirp) {
+            for(size_t k = 0; k < n; ++k)
+              out[k*inner] = bluestein::mul(line[k], chirp->chirp[k]);
+          } else {
+            for(size_t k = 0; k < n; ++k)
+              out[k*inner] = line[k];
+          }
+        }
+      }
+    }
+  };
+
+  using Inplace_Bluestein_Complex = gearshifft::FFT<FFT_Inplace_Bluestein_Complex,
+                                                    FFT_Plan_Not_Reusable,
+                                                    FftwBluesteinImpl,
+                                                    TimerCPU>;
+
+  using Outplace_Bluestein_Complex = gearshifft::FFT<FFT_Outplace_Bluestein_Complex,
+                                                     FFT_Plan_Not_Reusable,
+                                                     FftwBluesteinImpl,
+                                                     TimerCPU>;
+} // namespace fftw
+} // namespace gearshifft
+
+#endif /* FFTW_BLUESTEIN_HPP_ */
@@ -0,0 +1,401 @@
+#ifndef FFTW_FOURSTEP_HPP_
+#define FFTW_FOURSTEP_HPP_
+
+#include "fftw.hpp"
+#include "fftw_transpose.hpp"
+#include "core/parallel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace gearshifft {
+namespace fftw {
+
+  namespace fourstep {
+
+    /// configuration of the next benchmark runs, see FftwOptions::four_step_variants()
+    struct Config {
+      /// 4 = four-step, 6 = six-step
+      size_t steps = 4;
+      size_t block = 32;
+      /// 0 = FFTW threads
+      size_t threads = 0;
+    };
+
+    inline Config& selected() {
+      static Config config;
+      return config;
+    }
+
+    inline void select_variant(const std::string& variant) {
+      Config config;
+      std::stringstream ss(variant);
+      std::string token;
+      while(std::getline(ss, token, ';')) {
+        const auto pos = token.find('=');
+        const std::string key = token.substr(0, pos);
+        const std::string value = pos == std::string::npos ? "" : token.substr(pos+1);
+        if(key == "steps")
+          config.steps = std::stoul(value);
+        else if(key == "block")
+          config.block = std::stoul(value);
+        else if(key == "transpose-threads")
+          config.threads = std::stoul(value);
+        else
+          throw std::runtime_error("Invalid four-step variant '"+variant+"'.");
+      }
+      selected() = config;
+    }
+
+    /// largest divisor n1 <= sqrt(n) of n, n = n1*n2 (1 for prime n)
+    inline size_t split(size_t n) {
+      size_t n1 = static_cast<size_t>(std::sqrt(static_cast<double>(n)));
+      while(n1 > 1 && (n1*n1 > n || n % n1 != 0))
+        --n1;
+      return std::max<size_t>(n1, 1);
+    }
+
+    /**
+     * Twiddle factors w^m = exp(sign*2*pi*i*m/n), m < n, of a transform of
+     * size n. Stored as two tables of about sqrt(n) entries,
+     * w^m = high[m >> shift] * low[m & mask], so the table stays in cache
+     * even for very large n.
+     */
+    template<typename TReal>
+    struct Twiddles {
+      using Value = std::complex<TReal>;
+
+      std::vector<Value> low;
+      std::vector<Value> high;
+      size_t shift = 0;
+      size_t mask = 0;
+
+      Twiddles() = default;
+
+      Twiddles(size_t n, int sign) {
+        while((size_t(1) << (2*shift)) < n)
+          ++shift;
+        const size_t s = size_t(1) << shift;
+        mask = s - 1;
+        low.resize(s);
+        for(size_t m = 0; m < s; ++m)
+          low[m] = root(m, n, sign);
+        high.resize((n + s - 1) / s);
+        for(size_t q = 0; q < high.size(); ++q)
+          high[q] = root(q * s, n, sign);
+      }
+
+      static Value root(size_t m, size_t n, int sign) {
+        const long double pi = 3.141592653589793238462643383279502884L;
+        const long double phi = sign * 2 * pi * static_cast<long double>(m) / static_cast<long double>(n);
+        return Value(static_cast<TReal>(std::cos(phi)), static_cast<TReal>(std::sin(phi)));
+      }
+
+      size_t bytes() const {
+        return (low.size() + high.size()) * sizeof(Value);
+      }
+
+      /**
+       * Multiplies element [r*cols + c] of a rows x cols matrix by w^(r*c),
+       * contiguous ranges of rows are distributed to the threads.
+       */
+      void apply(Value* data, size_t rows, size_t cols, size_t threads) const {
+        auto twiddle_rows = [=](size_t, size_t begin, size_t end) {
+          for(size_t r = begin; r < end; ++r) {
+            Value* row = data + r*cols;
+            size_t m = 0;
+            for(size_t c = 0; c < cols; ++c, m += r) {
+              const Value& h = high[m >> shift];
+              const Value& l = low[m & mask];
+              // explicit products, std::complex multiplication checks for NaN/Inf
+              const TReal wr = h.real()*l.real() - h.imag()*l.imag();
+              const TReal wi = h.real()*l.imag() + h.imag()*l.real();
+              const TReal xr = row[c].real();
+              const TReal xi = row[c].imag();
+              row[c] = Value(xr*wr - xi*wi, xr*wi + xi*wr);
+            }
+          }
+        };
+        threads = std::max<size_t>(1, std::min(threads, rows));
+        if(threads == 1)
+          twiddle_rows(0, 0, rows);
+        else
+          parallel::for_each_chunk(rows, threads, twiddle_rows);
+      }
+    };
+
+  } // namespace fourstep
+
+  /**
+   * Complex 1D FFTs of size n = n1*n2 (n1 is the largest divisor <= sqrt(n))
+   * by the four-step algorithm, which keeps the working set of each FFT in
+   * cache: n2 strided FFTs of size n1 (columns of the n1 x n2 matrix), a
+   * twiddle pass, n1 contiguous FFTs of size n2 and a blocked transpose.
+   * The six-step variant (--steps 6) replaces the strided FFTs by a transpose,
+   * so all FFTs are contiguous, at the cost of two more transposes.
+   * The FFTs are batched FFTW plans (threads of -n), twiddle pass and
+   * transposes are threaded by --transpose-threads.
+   * The times of the FFT passes, the twiddle pass and the transposes are
+   * recorded as StageFFT, StageTwiddle and StageTranspose.
+   */
+  template<typename TFFT, // FFT_Inplace_FourStep_Complex or FFT_Outplace_FourStep_Complex
+           typename TPrecision, // double, float
+           size_t   NDim // 1
+           >
+  struct FftwFourStepImpl
+  {
+    using Extent = std::array<std::size_t, NDim>;
+    using PlanAPI = typename traits::plan<TPrecision>;
+    using ComplexType = typename traits::plan<TPrecision>::ComplexType;
+    using RealType = typename traits::plan<TPrecision>::RealType;
+    using PlanType = typename traits::plan<TPrecision>::PlanType;
+    using MemoryAPI = typename traits::memory_api<TPrecision>;
+    using Value = std::complex<RealType>;
+    using Twiddles = fourstep::Twiddles<RealType>;
+
+    static_assert(TFFT::IsComplex, "Four-step benchmarks are complex transforms only.");
+
+    static constexpr bool IsInplace = TFFT::IsInplace;
+    static constexpr bool UsesHostMemory = true;
+
+    size_t n_ = 0;
+    size_t n1_ = 1;
+    size_t n2_ = 1;
+    size_t steps_ = 4;
+    size_t block_ = 32;
+    size_t threads_ = 1;
+
+    ComplexType* data_ = nullptr;
+    ComplexType* data_complex_ = nullptr;
+    ComplexType* work_ = nullptr;
+
+    /// FFTs of size n1 and n2 per direction
+    std::array<PlanType, 2> fwd_plans_ = {{nullptr, nullptr}};
+    std::array<PlanType, 2> bwd_plans_ = {{nullptr, nullptr}};
+    Twiddles fwd_twiddles_;
+    Twiddles bwd_twiddles_;
+
+    /// time of the FFT passes, the twiddle passes and the transposes of forward and inverse transform [ms]
+    double fft_time_ = 0.0;
+    double twiddle_time_ = 0.0;
+    double transpose_time_ = 0.0;
+
+    FftwFourStepImpl(const Extent& cextents) {
+      n_ = cextents[0];
+      n1_ = fourstep::split(n_);
+      n2_ = n_ / n1_;
+      const auto& config = fourstep::selected();
+      steps_ = config.steps;
+      block_ = config.block;
+      threads_ = config.threads > 0 ? config.threads : std::max<size_t>(1, FftwContext::used_threads());
+
+      if(FftwContext::fresh_planner())
+        FftwContext::init_planner<TPrecision>();
+    }
+
+    ~FftwFourStepImpl() {
+      destroy();
+      if(FftwContext::fresh_planner())
+        FftwContext::cleanup_planner<TPrecision>();
+    }
+
+    /// four-step benchmarks of 1D extents are only run with --four-step and native FFTW
+    static bool enabled() {
+      return NDim == 1 && native_fftw() && FftwContext::options().four_step();
+    }
+
+    /// algorithms and transpose configurations to be compared (--steps, --transpose-block, --transpose-threads)
+    static std::vector<std::string> variants() {
+      return FftwContext::options().four_step_variants();
+    }
+
+    static void select_variant(const std::string& variant) {
+      fourstep::select_variant(variant);
+    }
+
+    std::vector<std::pair<RecordType, double> > get_stage_times() const {
+      return {{RecordType::StageFFT, fft_time_},
+              {RecordType::StageTwiddle, twiddle_time_},
+              {RecordType::StageTranspose, transpose_time_}};
+    }
+
+    /// data buffers and transpose buffer, see FFT::footprint()
+    static FFTFootprint footprint(const Extent& cextents) {
+      const size_t n = cextents[0];
+      FFTFootprint fp;
+      fp.allocation = (IsInplace ? 2 : 3) * n * sizeof(ComplexType);
+      fp.transfer = n * sizeof(ComplexType);
+      return fp;
+    }
+
+    size_t get_allocation_size() {
+      return (IsInplace ? 2 : 3) * n_ * sizeof(ComplexType);
+    }
+
+    /// twiddle tables
+    size_t get_plan_size() {
+      return fwd_twiddles_.bytes() + bwd_twiddles_.bytes();
+    }
+
+    size_t get_transfer_size() {
+      return n_ * sizeof(ComplexType);
+    }
+
+    void init_forward() {
+      fwd_twiddles_ = Twiddles(n_, -1);
+      create_plans(fwd_plans_, data_, data_complex_, traits::fftw_direction::forward);
+    }
+
+    void init_inverse() {
+      bwd_twiddles_ = Twiddles(n_, 1);
+      create_plans(bwd_plans_, data_complex_, data_, traits::fftw_direction::inverse);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    // --- next methods are benchmarked ---
+
+    void allocate() {
+      data_ = static_cast<ComplexType*>(MemoryAPI::malloc(n_ * sizeof(ComplexType)));
+      data_complex_ = IsInplace ? data_
+                                : static_cast<ComplexType*>(MemoryAPI::malloc(n_ * sizeof(ComplexType)));
+      work_ = static_cast<ComplexType*>(MemoryAPI::malloc(n_ * sizeof(ComplexType)));
+    }
+
+    void execute_forward() {
+      execute(fwd_plans_, fwd_twiddles_, data_, data_complex_);
+    }
+
+    void execute_inverse() {
+      execute(bwd_plans_, bwd_twiddles_, data_complex_, data_);
+    }
+
+    template<typename THostData>
+    void upload(THostData* input) {
+      MemoryAPI::memcpy(data_, input, n_ * sizeof(ComplexType));
+    }
+
+    template<typename THostData>
+    void download(THostData* output) {
+      MemoryAPI::memcpy(output, data_, n_ * sizeof(ComplexType));
+    }
+
+    void destroy() {
+      for(size_t k = 0; k < 2; ++k) {
+        if(fwd_plans_[k])
+          PlanAPI::destroy(fwd_plans_[k]);
+        fwd_plans_[k] = nullptr;
+        if(bwd_plans_[k])
+          PlanAPI::destroy(bwd_plans_[k]);
+        bwd_plans_[k] = nullptr;
+      }
+
+      if(data_complex_ && !IsInplace)
+        MemoryAPI::free(data_complex_);
+      data_complex_ = nullptr;
+
+      if(data_)
+        MemoryAPI::free(data_);
+      data_ = nullptr;
+
+      if(work_)
+        MemoryAPI::free(work_);
+      work_ = nullptr;
+    }
+
+  private:
+
+    /**
+     * Four-step: plans[0] = n2 strided FFTs of size n1 (src -> dst),
+     *            plans[1] = n1 FFTs of size n2 (dst -> work).
+     * Six-step:  plans[0] = n2 FFTs of size n1 (in-place on work),
+     *            plans[1] = n1 FFTs of size n2 (dst -> work).
+     */
+    void create_plans(std::array<PlanType, 2>& plans,
+                      ComplexType* src,
+                      ComplexType* dst,
+                      traits::fftw_direction dir) {
+      const unsigned flags = FftwContext::options().plan_rigor();
+      traits::layout columns;
+      columns.howmany = n2_;
+      if(steps_ == 4) {
+        columns.in_stride = n2_;
+        columns.out_stride = n2_;
+        columns.in_dist = 1;
+        columns.out_dist = 1;
+        plans[0] = PlanAPI::create(std::array<size_t, 1>{{n1_}}, src, dst, dir, flags, columns);
+      } else {
+        columns.in_dist = n1_;
+        columns.out_dist = n1_;
+        plans[0] = PlanAPI::create(std::array<size_t, 1>{{n1_}}, work_, work_, dir, flags, columns);
+      }
+      traits::layout rows;
+      rows.howmany = n1_;
+      rows.in_dist = n2_;
+      rows.out_dist = n2_;
+      plans[1] = PlanAPI::create(std::array<size_t, 1>{{n2_}}, dst, work_, dir, flags, rows);
+      if(!plans[0] || !plans[1])
+        throw std::runtime_error("fftw plan of a four-step pass could not be created.");
+    }
+
+    void execute(const std::array<PlanType, 2>& plans,
+                 const Twiddles& twiddles,
+                 ComplexType* src,
+                 ComplexType* dst) {
+      Value* vsrc = reinterpret_cast<Value*>(src);
+      Value* vdst = reinterpret_cast<Value*>(dst);
+      Value* vwork = reinterpret_cast<Value*>(work_);
+      TimerCPU timer;
+      if(steps_ == 4) {
+        // columns of the n1 x n2 matrix, twiddles w^(k1*j2)
+        timer.startTimer();
+        PlanAPI::execute(plans[0]);
+        fft_time_ += timer.stopTimer();
+        timer.startTimer();
+        twiddles.apply(vdst, n1_, n2_, threads_);
+        twiddle_time_ += timer.stopTimer();
+      } else {
+        // n1 x n2 -> n2 x n1, rows of size n1, twiddles w^(j2*k1), n2 x n1 -> n1 x n2
+        timer.startTimer();
+        transpose_blocked(vsrc, vwork, n1_, n2_, block_, threads_);
+        transpose_time_ += timer.stopTimer();
+        timer.startTimer();
+        PlanAPI::execute(plans[0]);
+        fft_time_ += timer.stopTimer();
+        timer.startTimer();
+        twiddles.apply(vwork, n2_, n1_, threads_);
+        twiddle_time_ += timer.stopTimer();
+        timer.startTimer();
+        transpose_blocked(vwork, vdst, n2_, n1_, block_, threads_);
+        transpose_time_ += timer.stopTimer();
+      }
+      // rows of size n2, the n1 x n2 result is transposed to natural order
+      timer.startTimer();
+      PlanAPI::execute(plans[1]);
+      fft_time_ += timer.stopTimer();
+      timer.startTimer();
+      transpose_blocked(vwork, vdst, n1_, n2_, block_, threads_);
+      transpose_time_ += timer.stopTimer();
+    }
+  };
+
+  using Inplace_FourStep_Complex = gearshifft::FFT<FFT_Inplace_FourStep_Complex,
+                                                   FFT_Plan_Not_Reusable,
+                                                   FftwFourStepImpl,
+                                                   TimerCPU>;
+
+  using Outplace_FourStep_Complex = gearshifft::FFT<FFT_Outplace_FourStep_Complex,
+                                                    FFT_Plan_Not_Reusable,
+                                                    FftwFourStepImpl,
+                                                    TimerCPU>;
+} // namespace fftw
+} // namespace gearshifft
+
+#endif /* FFTW_FOURSTEP_HPP_ */
@@ -0,0 +1,551 @@
+#ifndef FFTW_MPI_HPP_
+#define FFTW_MPI_HPP_
+
+#include "fftw.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <mpi.h>
+#include <fftw3-mpi.h>
+
+namespace gearshifft {
+namespace fftw_mpi {
+
+  class FftwMpiOptions : public OptionsDefault {
+
+  public:
+
+    FftwMpiOptions() : OptionsDefault() {
+      add_options()
+        ("rigor", value(&rigor_)->default_value("measure"), "FFTW rigor (measure, estimate, patient or exhaustive).")
+        ("transposed", boost::program_options::bool_switch(&transposed_), "Forward transforms leave the output transposed (FFTW_MPI_TRANSPOSED_OUT), the inverse transforms take transposed input (FFTW_MPI_TRANSPOSED_IN). Saves one all-to-all per transform.");
+    }
+
+    const std::string& plan_rigor_str() const {
+      return rigor_;
+    }
+
+    unsigned plan_rigor() const {
+      if(rigor_ == "wisdom")
+        throw std::runtime_error("wisdom rigor not supported by FFTW MPI benchmarks.");
+      return fftw::FftwOptions::rigor_flags(rigor_);
+    }
+
+    bool transposed() const {
+      return transposed_;
+    }
+
+  private:
+    std::string rigor_;
+    bool transposed_ = false;
+  };
+
+
+  namespace traits {
+
+    /**
+     * FFTW MPI functions of a precision, all processes of MPI_COMM_WORLD
+     * take part in the transforms (slab decomposition along the first dimension).
+     */
+    template<typename T_Precision>
+    struct mpi_api {};
+
+    template<>
+    struct mpi_api<float> {
+      using ComplexType = fftwf_complex;
+      using RealType = float;
+      using PlanType = fftwf_plan;
+
+      static void init() { fftwf_mpi_init(); }
+
+      static void cleanup() { fftwf_mpi_cleanup(); }
+
+      /// local sizes of the input (first dimension) and transposed output (second dimension)
+      static ptrdiff_t local_size(int rank, const ptrdiff_t* n,
+                                  ptrdiff_t* local_n0, ptrdiff_t* local_0_start,
+                                  ptrdiff_t* local_n1, ptrdiff_t* local_1_start) {
+        return fftwf_mpi_local_size_transposed(rank, n, MPI_COMM_WORLD,
+                                               local_n0, local_0_start,
+                                               local_n1, local_1_start);
+      }
+
+      static PlanType plan_dft(int rank, const ptrdiff_t* n, ComplexType* in, ComplexType* out,
+                               int sign, unsigned flags) {
+        return fftwf_mpi_plan_dft(rank, n, in, out, MPI_COMM_WORLD, sign, flags);
+      }
+
+      static PlanType plan_dft(int rank, const ptrdiff_t* n, RealType* in, ComplexType* out,
+                               int, unsigned flags) {
+        return fftwf_mpi_plan_dft_r2c(rank, n, in, out, MPI_COMM_WORLD, flags);
+      }
+
+      static PlanType plan_dft(int rank, const ptrdiff_t* n, ComplexType* in, RealType* out,
+                               int, unsigned flags) {
+        return fftwf_mpi_plan_dft_c2r(rank, n, in, out, MPI_COMM_WORLD, flags);
+      }
+
+      /// global transpose of a n0 x n1 matrix of howmany-tuples
+      static PlanType plan_transpose(ptrdiff_t n0, ptrdiff_t n1, ptrdiff_t howmany,
+                                     RealType* in, RealType* out, unsigned flags) {
+        return fftwf_mpi_plan_many_transpose(n0, n1, howmany,
+                                             FFTW_MPI_DEFAULT_BLOCK, FFTW_MPI_DEFAULT_BLOCK,
+                                             in, out, MPI_COMM_WORLD, flags);
+      }
+    };
+
+    template<>
+    struct mpi_api<double> {
+      using ComplexType = fftw_complex;
+      using RealType = double;
+      using PlanType = fftw_plan;
+
+      static void init() { fftw_mpi_init(); }
+
+      static void cleanup() { fftw_mpi_cleanup(); }
+
+      static ptrdiff_t local_size(int rank, const ptrdiff_t* n,
+                                  ptrdiff_t* local_n0, ptrdiff_t* local_0_start,
+                                  ptrdiff_t* local_n1, ptrdiff_t* local_1_start) {
+        return fftw_mpi_local_size_transposed(rank, n, MPI_COMM_WORLD,
+                                              local_n0, local_0_start,
+                                              local_n1, local_1_start);
+      }
+
+      static PlanType plan_dft(int rank, const ptrdiff_t* n, ComplexType* in, ComplexType* out,
+                               int sign, unsigned flags) {
+        return fftw_mpi_plan_dft(rank, n, in, out, MPI_COMM_WORLD, sign, flags);
+      }
+
+      static PlanType plan_dft(int rank, const ptrdiff_t* n, RealType* in, ComplexType* out,
+                               int, unsigned flags) {
+        return fftw_mpi_plan_dft_r2c(rank, n, in, out, MPI_COMM_WORLD, flags);
+      }
+
+      static PlanType plan_dft(int rank, const ptrdiff_t* n, ComplexType* in, RealType* out,
+                               int, unsigned flags) {
+        return fftw_mpi_plan_dft_c2r(rank, n, in, out, MPI_COMM_WORLD, flags);
+      }
+
+      static PlanType plan_transpose(ptrdiff_t n0, ptrdiff_t n1, ptrdiff_t howmany,
+                                     RealType* in, RealType* out, unsigned flags) {
+        return fftw_mpi_plan_many_transpose(n0, n1, howmany,
+                                            FFTW_MPI_DEFAULT_BLOCK, FFTW_MPI_DEFAULT_BLOCK,
+                                            in, out, MPI_COMM_WORLD, flags);
+      }
+    };
+
+    /// byte count or displacement of MPI calls
+    inline int mpi_count(size_t bytes) {
+      if(bytes > static_cast<size_t>(std::numeric_limits<int>::max()))
+        throw std::runtime_error("Data of an MPI process exceeds the MPI count limit.");
+      return static_cast<int>(bytes);
+    }
+
+  } // namespace traits
+
+
+  /**
+   * FFTW MPI context, benchmarks are run by every process of `mpirun -np <N>`.
+   *
+   * Results of all processes are gathered on rank 0, which writes the result
+   * file. A result is recorded per rank (variant "rank=<k>").
+   */
+  struct FftwMpiContext : public ContextDefault<FftwMpiOptions> {
+
+    static const std::string title() {
+      return "FftwMpi";
+    }
+
+    static std::string get_device_list() {
+      return "FFTW MPI benchmarks use the processes of mpirun.\n";
+    }
+
+    static int rank() {
+      return state().rank;
+    }
+
+    static int processes() {
+      return state().size;
+    }
+
+    static bool is_root() {
+      return rank() == 0;
+    }
+
+    /**
+     * Gathers the values of a result of all processes on rank 0,
+     * which adds one result per rank. Other attributes are taken from rank 0.
+     */
+    template<typename T_Result>
+    static std::vector<T_Result> gather(const T_Result& result) {
+      using ValuesT = typename std::decay<decltype(result.getValues())>::type;
+      const int count = static_cast<int>(sizeof(ValuesT)/sizeof(double));
+      std::vector<ValuesT> values(is_root() ? static_cast<size_t>(processes()) : 0);
+      MPI_Gather(result.getValues().data(), count, MPI_DOUBLE,
+                 values.data(), count, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+      std::vector<T_Result> records;
+      for(size_t k = 0; k < values.size(); ++k) {
+        T_Result record = result;
+        std::stringstream variant;
+        if(!result.getVariant().empty())
+          variant << result.getVariant() << ";";
+        variant << "rank=" << k;
+        record.setValues(values[k]);
+        record.setVariant(variant.str());
+        records.push_back(record);
+      }
+      return records;
+    }
+
+    void create() {
+      int initialized = 0;
+      MPI_Initialized(&initialized);
+      if(!initialized && MPI_Init(nullptr, nullptr) != MPI_SUCCESS)
+        throw std::runtime_error("MPI initialization failed.");
+      MPI_Comm_rank(MPI_COMM_WORLD, &state().rank);
+      MPI_Comm_size(MPI_COMM_WORLD, &state().size);
+      options().plan_rigor(); // validates rigor
+      parallel::set_threads(options().getNumberDevices());
+      traits::mpi_api<float>::init();
+      traits::mpi_api<double>::init();
+    }
+
+    void destroy() {
+      traits::mpi_api<float>::cleanup();
+      traits::mpi_api<double>::cleanup();
+      int finalized = 0;
+      MPI_Finalized(&finalized);
+      if(!finalized)
+        MPI_Finalize();
+    }
+
+    std::string get_used_device_properties() {
+      std::ostringstream msg;
+      msg << "\"MpiProcesses\"," << processes()
+          << ",\"TotalMemory\"," << getMemorySize()
+          << ",\"AvailableMemory\"," << getAvailableMemorySize()
+          << ",\"PlanRigor\",\"" << options().plan_rigor_str() << "\""
+          << ",\"Transposed\",\"" << (options().transposed() ? "on" : "off") << "\"";
+      return msg.str();
+    }
+
+  private:
+    struct State {
+      int rank = 0;
+      int size = 1;
+    };
+
+    static State& state() {
+      static State s;
+      return s;
+    }
+  };
+
+
+  /**
+   * FFTW MPI plan and execution class.
+   *
+   * This class handles:
+   * - {2D, 3D} x {R2C, C2R, C2C} x {inplace, outplace} x {float, double}.
+   *
+   * Arrays are distributed in slabs of the first dimension (FFTW does not
+   * provide pencil decompositions). Upload copies the local slab from the
+   * host data, download gathers all slabs into the host data of every rank.
+   */
+  template<typename TFFT, // see fft_abstract.hpp (FFT_Inplace_Real, ...)
+           typename TPrecision, // double, float
+           size_t   NDim // 2..3
+           >
+  struct FftwMpiImpl
+  {
+    using Extent = std::array<std::size_t, NDim>;
+    using MpiAPI = traits::mpi_api<TPrecision>;
+    using PlanAPI = typename fftw::traits::plan<TPrecision>;
+    using MemoryAPI = typename fftw::traits::memory_api<TPrecision>;
+    using ComplexType = typename MpiAPI::ComplexType;
+    using RealType = typename MpiAPI::RealType;
+    using PlanType = typename MpiAPI::PlanType;
+
+    static_assert(NDim > 0 && NDim < 4, "[fftw_mpi.hpp]\treceived NDim not in [1,3], currently unsupported" );
+
+    static constexpr
+    bool IsInplace = TFFT::IsInplace;
+    static constexpr
+    bool IsComplex = TFFT::IsComplex;
+    /// buffers are allocated in host memory, see FFT::footprint()
+    static constexpr
+    bool UsesHostMemory = true;
+
+    using value_type  = typename std::conditional<IsComplex,ComplexType,RealType>::type;
+
+    /// extents of the FFT input data
+    Extent extents_   = {{0}};
+    /// product of extents
+    size_t n_         = 0;
+    /// elements of the last dimension in the host data and in the local buffer (padded for R2C)
+    size_t row_ = 0;
+    size_t pitch_ = 0;
+    /// rows of the last dimension per index of the first dimension
+    size_t slab_rows_ = 1;
+    /// local slab of the input: first index and number of indices of the first dimension
+    ptrdiff_t local_n0_ = 0;
+    ptrdiff_t local_0_start_ = 0;
+    ptrdiff_t local_n1_ = 0;
+    ptrdiff_t local_1_start_ = 0;
+    /// complex elements of the local buffers
+    ptrdiff_t alloc_local_ = 0;
+
+    PlanType      fwd_plan_          = nullptr;
+    PlanType      bwd_plan_          = nullptr;
+    value_type*   data_              = nullptr;
+    ComplexType*  data_complex_      = nullptr;
+    size_t        data_size_         = 0;
+    size_t        data_complex_size_ = 0;
+
+    /// bytes and displacements of the slabs of all ranks in the host data (download)
+    std::vector<int> counts_;
+    std::vector<int> displs_;
+
+    unsigned plan_rigor_ = FftwMpiContext::options().plan_rigor();
+    bool transposed_ = FftwMpiContext::options().transposed();
+
+    FftwMpiImpl(const Extent& cextents) {
+      extents_ = interpret_as::column_major(cextents);
+      n_ = std::accumulate(extents_.begin(),
+                           extents_.end(),
+                           static_cast<size_t>(1),
+                           fftw::traits::checked_size);
+      row_ = extents_.back();
+      slab_rows_ = n_ / extents_.front() / row_;
+
+      // local sizes of R2C transforms refer to the complex array
+      std::array<ptrdiff_t, NDim> n;
+      std::copy(extents_.begin(), extents_.end(), n.begin());
+      if(!IsComplex)
+        n.back() = static_cast<ptrdiff_t>(row_/2 + 1);
+      alloc_local_ = MpiAPI::local_size(static_cast<int>(NDim), n.data(),
+                                        &local_n0_, &local_0_start_,
+                                        &local_n1_, &local_1_start_);
+
+      // real rows are padded to hold a complex row, also for out-of-place transforms
+      pitch_ = IsComplex ? row_ : 2*(row_/2 + 1);
+      if(IsComplex) {
+        data_size_ = fftw::traits::checked_size(static_cast<size_t>(alloc_local_), sizeof(ComplexType));
+      } else {
+        data_size_ = fftw::traits::checked_size(2*static_cast<size_t>(alloc_local_), sizeof(RealType));
+      }
+      if(!IsInplace)
+        data_complex_size_ = fftw::traits::checked_size(static_cast<size_t>(alloc_local_), sizeof(ComplexType));
+    }
+
+    ~FftwMpiImpl() {
+      destroy();
+    }
+
+    /// distributed transforms of one dimension are not supported
+    static bool enabled() {
+      return NDim > 1;
+    }
+
+    /// local buffers of this rank, see FFT::footprint()
+    static FFTFootprint footprint(const Extent& cextents) {
+      // the constructor only queries the local size, no plans or buffers are created
+      FftwMpiImpl fft(cextents);
+      FFTFootprint fp;
+      fp.allocation = fft.get_allocation_size();
+      fp.transfer = fft.get_transfer_size();
+      return fp;
+    }
+
+    /// local buffers of this rank
+    size_t get_allocation_size() {
+      return data_size_ + data_complex_size_;
+    }
+
+    size_t get_plan_size() {
+      return 0;
+    }
+
+    /// size of the host data, which is gathered on download
+    size_t get_transfer_size() {
+      return n_*sizeof(value_type);
+    }
+
+    /**
+     * Estimated all-to-all time of forward and inverse transform [ms].
+     *
+     * The global transposes of the slab decomposition (two per transform,
+     * one with transposed output) are timed on buffers of the local size.
+     * Called after the benchmarked methods by all ranks.
+     */
+    double get_communication_time() {
+      // complex array: n0 x n1 matrix of tuples of the remaining dimensions
+      Extent cextents = extents_;
+      if(!IsComplex)
+        cextents.back() = row_/2 + 1;
+      const size_t tuple = std::accumulate(cextents.begin()+2, cextents.end(),
+                                           static_cast<size_t>(2), fftw::traits::checked_size);
+      const ptrdiff_t n0 = static_cast<ptrdiff_t>(cextents[0]);
+      const ptrdiff_t n1 = static_cast<ptrdiff_t>(cextents[1]);
+      const ptrdiff_t howmany = static_cast<ptrdiff_t>(tuple);
+      const size_t bytes = fftw::traits::checked_size(2*static_cast<size_t>(alloc_local_), sizeof(RealType));
+
+      RealType* in = static_cast<RealType*>(MemoryAPI::malloc(bytes));
+      RealType* out = static_cast<RealType*>(MemoryAPI::malloc(bytes));
+      PlanType plan = MpiAPI::plan_transpose(n0, n1, howmany, in, out, FFTW_ESTIMATE);
+      double time = 0.0;
+      if(plan) {
+        std::memset(in, 0, bytes);
+        const int transposes = transposed_ ? 2 : 4;
+        TimerCPU timer;
+        MPI_Barrier(MPI_COMM_WORLD);
+        timer.startTimer();
+        for(int k = 0; k < transposes; ++k)
+          PlanAPI::execute(plan);
+        time = timer.stopTimer();
+        PlanAPI::destroy(plan);
+      }
+      MemoryAPI::free(in);
+      MemoryAPI::free(out);
+      if(!plan)
+        throw std::runtime_error("fftw mpi transpose plan could not be created.");
+      return time;
+    }
+
+    void init_forward() {
+      fwd_plan_ = create_plan(data_, data_complex_, FFTW_FORWARD,
+                              plan_rigor_ | (transposed_ ? FFTW_MPI_TRANSPOSED_OUT : 0));
+      if(!fwd_plan_)
+        throw std::runtime_error("fftw mpi forward plan could not be created.");
+
+      // slabs of all ranks for the download
+      const size_t slab_bytes = slab_rows_ * row_ * sizeof(value_type);
+      const long local[2] = {static_cast<long>(local_n0_), static_cast<long>(local_0_start_)};
+      const size_t processes = static_cast<size_t>(FftwMpiContext::processes());
+      std::vector<long> all(2*processes);
+      MPI_Allgather(local, 2, MPI_LONG, all.data(), 2, MPI_LONG, MPI_COMM_WORLD);
+      counts_.resize(processes);
+      displs_.resize(processes);
+      for(size_t k = 0; k < counts_.size(); ++k) {
+        counts_[k] = traits::mpi_count(static_cast<size_t>(all[2*k]) * slab_bytes);
+        displs_[k] = traits::mpi_count(static_cast<size_t>(all[2*k+1]) * slab_bytes);
+      }
+    }
+
+    void init_inverse() {
+      bwd_plan_ = create_plan(data_complex_, data_, FFTW_BACKWARD,
+                              plan_rigor_ | (transposed_ ? FFTW_MPI_TRANSPOSED_IN : 0));
+      if(!bwd_plan_)
+        throw std::runtime_error("fftw mpi inverse plan could not be created.");
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    // --- next methods are benchmarked ---
+
+    void allocate() {
+      data_ = static_cast<value_type*>(MemoryAPI::malloc(data_size_));
+      if(IsInplace){
+        data_complex_ = reinterpret_cast<ComplexType*>(data_);
+      }
+      else{
+        data_complex_ = static_cast<ComplexType*>(MemoryAPI::malloc(data_complex_size_));
+      }
+    }
+
+    void execute_forward() {
+      PlanAPI::execute(fwd_plan_);
+    }
+
+    void execute_inverse() {
+      PlanAPI::execute(bwd_plan_);
+    }
+
+    /// copies the local slab of the host data
+    template<typename THostData>
+    void upload(THostData* input) {
+      const value_type* in = reinterpret_cast<const value_type*>(input);
+      const size_t first = static_cast<size_t>(local_0_start_) * slab_rows_;
+      const size_t rows = static_cast<size_t>(local_n0_) * slab_rows_;
+      for(size_t r = 0; r < rows; ++r)
+        MemoryAPI::memcpy(data_ + r*pitch_, in + (first+r)*row_, row_*sizeof(value_type));
+    }
+
+    /// gathers the slabs of all ranks into the host data
+    template<typename THostData>
+    void download(THostData* output) {
+      value_type* out = reinterpret_cast<value_type*>(output);
+      const size_t first = static_cast<size_t>(local_0_start_) * slab_rows_;
+      const size_t rows = static_cast<size_t>(local_n0_) * slab_rows_;
+      for(size_t r = 0; r < rows; ++r)
+        MemoryAPI::memcpy(out + (first+r)*row_, data_ + r*pitch_, row_*sizeof(value_type));
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+      MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL,
+                     output, counts_.data(), displs_.data(), MPI_BYTE, MPI_COMM_WORLD);
+#pragma GCC diagnostic pop
+    }
+
+    void destroy() {
+
+      if(data_)
+        MemoryAPI::free(data_);
+      data_ = nullptr;
+
+      if(data_complex_ && !IsInplace)
+        MemoryAPI::free(data_complex_);
+      data_complex_ = nullptr;
+
+      if(fwd_plan_)
+        PlanAPI::destroy(fwd_plan_);
+      fwd_plan_ = nullptr;
+
+      if(bwd_plan_)
+        PlanAPI::destroy(bwd_plan_);
+      bwd_plan_ = nullptr;
+    }
+
+  private:
+
+    template<typename TIn, typename TOut>
+    PlanType create_plan(TIn* in, TOut* out, int sign, unsigned flags) {
+      std::array<ptrdiff_t, NDim> n;
+      std::copy(extents_.begin(), extents_.end(), n.begin());
+      return MpiAPI::plan_dft(static_cast<int>(NDim), n.data(), in, out, sign, flags);
+    }
+  };
+
+  using Inplace_Real = gearshifft::FFT<FFT_Inplace_Real,
+                                       FFT_Plan_Not_Reusable,
+                                       FftwMpiImpl,
+                                       TimerCPU>;
+
+  using Outplace_Real = gearshifft::FFT<FFT_Outplace_Real,
+                                        FFT_Plan_Not_Reusable,
+                                        FftwMpiImpl,
+                                        TimerCPU>;
+
+  using Inplace_Complex = gearshifft::FFT<FFT_Inplace_Complex,
+                                          FFT_Plan_Not_Reusable,
+                                          FftwMpiImpl,
+                                          TimerCPU>;
+
+  using Outplace_Complex = gearshifft::FFT<FFT_Outplace_Complex,
+                                           FFT_Plan_Not_Reusable,
+                                           FftwMpiImpl,
+                                           TimerCPU>;
+} // namespace fftw_mpi
+} // namespace gearshifft
+
+
+#endif /* FFTW_MPI_HPP_ */
@@ -0,0 +1,549 @@
+#ifndef FFTW_PACKED_HPP_
+#define FFTW_PACKED_HPP_
+
+#include "fftw.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace gearshifft {
+namespace fftw {
+
+  namespace packing {
+
+    enum class Strategy {
+      /// n-point real signal by an n/2-point complex FFT of even and odd samples
+      Half,
+      /// two real signals by one complex FFT (real and imaginary part)
+      Pair
+    };
+
+    /// configuration of the next benchmark runs, see FftwOptions::packing_variants()
+    struct Config {
+      Strategy strategy = Strategy::Half;
+      size_t batch = 1;
+    };
+
+    inline Config& selected() {
+      static Config config;
+      return config;
+    }
+
+    inline void select_variant(const std::string& variant) {
+      Config config;
+      std::stringstream ss(variant);
+      std::string token;
+      while(std::getline(ss, token, ';')) {
+        const auto pos = token.find('=');
+        const std::string key = token.substr(0, pos);
+        const std::string value = pos == std::string::npos ? "" : token.substr(pos+1);
+        if(key == "packing" && (value == "half" || value == "pair"))
+          config.strategy = value == "half" ? Strategy::Half : Strategy::Pair;
+        else if(key == "batch")
+          config.batch = std::stoul(value);
+        else
+          throw std::runtime_error("Invalid packed real variant '"+variant+"'.");
+      }
+      selected() = config;
+    }
+
+    /**
+     * Post-processing of the half-length forward transform (m = n/2).
+     * s holds Z = FFT_m(x[2j] + i*x[2j+1]) in m interleaved complex values
+     * and gets X[0..m] of the real transform, w = exp(-2*pi*i*k/n), k <= m/2.
+     * X[k] = Fe + w^k*Fo and X[m-k] = conj(Fe - w^k*Fo) are computed pairwise
+     * from Fe = (Z[k] + conj(Z[m-k]))/2 and Fo = (Z[k] - conj(Z[m-k]))/(2i).
+     */
+    template<typename T>
+    void half_forward(T* s, size_t m, const T* wr, const T* wi) {
+      const T z0r = s[0];
+      const T z0i = s[1];
+      s[0] = z0r + z0i;
+      s[1] = 0;
+      s[2*m] = z0r - z0i;
+      s[2*m+1] = 0;
+      const size_t h = (m+1)/2;
+      const T half = static_cast<T>(0.5);
+#pragma omp simd
+      for(size_t k = 1; k < h; ++k) {
+        const T ar = s[2*k];
+        const T ai = s[2*k+1];
+        const T br = s[2*(m-k)];
+        const T bi = -s[2*(m-k)+1];
+        const T er = half*(ar + br);
+        const T ei = half*(ai + bi);
+        const T or_ = half*(ai - bi);
+        const T oi = -half*(ar - br);
+        const T tr = wr[k]*or_ - wi[k]*oi;
+        const T ti = wr[k]*oi + wi[k]*or_;
+        s[2*k] = er + tr;
+        s[2*k+1] = ei + ti;
+        s[2*(m-k)] = er - tr;
+        s[2*(m-k)+1] = ti - ei;
+      }
+      // X[m/2] = conj(Z[m/2])
+      if(m % 2 == 0 && m > 0)
+        s[m+1] = -s[m+1];
+    }
+
+    /**
+     * Pre-processing of the half-length inverse transform, inverse of half_forward
+     * (scaled by 2, so the unnormalized inverse FFT_m gives n*x like a C2R transform).
+     * Z[k] = E + u and Z[m-k] = conj(E - u) with E = X[k] + conj(X[m-k]),
+     * u = i*conj(w^k)*(X[k] - conj(X[m-k])).
+     */
+    template<typename T>
+    void half_inverse(T* s, size_t m, const T* wr, const T* wi) {
+      const T x0 = s[0];
+      const T xm = s[2*m];
+      s[0] = x0 + xm;
+      s[1] = x0 - xm;
+      const size_t h = (m+1)/2;
+#pragma omp simd
+      for(size_t k = 1; k < h; ++k) {
+        const T ar = s[2*k];
+        const T ai = s[2*k+1];
+        const T br = s[2*(m-k)];
+        const T bi = -s[2*(m-k)+1];
+        const T er = ar + br;
+        const T ei = ai + bi;
+        const T dr = ar - br;
+        const T di = ai - bi;
+        const T ur = wi[k]*dr - wr[k]*di;
+        const T ui = wr[k]*dr + wi[k]*di;
+        s[2*k] = er + ur;
+        s[2*k+1] = ei + ui;
+        s[2*(m-k)] = er - ur;
+        s[2*(m-k)+1] = ui - ei;
+      }
+      // Z[m/2] = 2*conj(X[m/2])
+      if(m % 2 == 0 && m > 0) {
+        s[m] = 2*s[m];
+        s[m+1] = -2*s[m+1];
+      }
+    }
+
+    /// w[k] = a[k] + i*b[k], b = nullptr packs a single signal
+    template<typename T>
+    void pair_pack(T* w, const T* a, const T* b, size_t n) {
+      if(b) {
+#pragma omp simd
+        for(size_t j = 0; j < n; ++j) {
+          w[2*j] = a[j];
+          w[2*j+1] = b[j];
+        }
+      } else {
+#pragma omp simd
+        for(size_t j = 0; j < n; ++j) {
+          w[2*j] = a[j];
+          w[2*j+1] = 0;
+        }
+      }
+    }
+
+    /**
+     * Spectra A, B (n/2+1 values each) of two real signals from W = FFT_n(a + i*b),
+     * A[k] = (W[k] + conj(W[n-k]))/2, B[k] = (W[k] - conj(W[n-k]))/(2i).
+     */
+    template<typename T>
+    void pair_unpack(T* a, T* b, const T* w, size_t n) {
+      a[0] = w[0];
+      a[1] = 0;
+      if(b) {
+        b[0] = w[1];
+        b[1] = 0;
+      }
+      const T half = static_cast<T>(0.5);
+      const size_t h = n/2;
+#pragma omp simd
+      for(size_t k = 1; k <= h; ++k) {
+        const T zr = w[2*k];
+        const T zi = w[2*k+1];
+        const T yr = w[2*(n-k)];
+        const T yi = -w[2*(n-k)+1];
+        a[2*k] = half*(zr + yr);
+        a[2*k+1] = half*(zi + yi);
+      }
+      if(!b)
+        return;
+#pragma omp simd
+      for(size_t k = 1; k <= h; ++k) {
+        const T zr = w[2*k];
+        const T zi = w[2*k+1];
+        const T yr = w[2*(n-k)];
+        const T yi = -w[2*(n-k)+1];
+        b[2*k] = half*(zi - yi);
+        b[2*k+1] = -half*(zr - yr);
+      }
+    }
+
+    /**
+     * W = A + i*B over the full length n from the spectra of two real signals,
+     * A[n-k] = conj(A[k]) and B[n-k] = conj(B[k]) for k > n/2.
+     */
+    template<typename T>
+    void pair_merge(T* w, const T* a, const T* b, size_t n) {
+      const size_t h = n/2;
+      if(b) {
+#pragma omp simd
+        for(size_t k = 0; k <= h; ++k) {
+          w[2*k] = a[2*k] - b[2*k+1];
+          w[2*k+1] = a[2*k+1] + b[2*k];
+        }
+#pragma omp simd
+        for(size_t k = h+1; k < n; ++k) {
+          w[2*k] = a[2*(n-k)] + b[2*(n-k)+1];
+          w[2*k+1] = b[2*(n-k)] - a[2*(n-k)+1];
+        }
+      } else {
+#pragma omp simd
+        for(size_t k = 0; k <= h; ++k) {
+          w[2*k] = a[2*k];
+          w[2*k+1] = a[2*k+1];
+        }
+#pragma omp simd
+        for(size_t k = h+1; k < n; ++k) {
+          w[2*k] = a[2*(n-k)];
+          w[2*k+1] = -a[2*(n-k)+1];
+        }
+      }
+    }
+
+    /// a[j] = Re w[j], b[j] = Im w[j]
+    template<typename T>
+    void pair_split(T* a, T* b, const T* w, size_t n) {
+#pragma omp simd
+      for(size_t j = 0; j < n; ++j)
+        a[j] = w[2*j];
+      if(!b)
+        return;
+#pragma omp simd
+      for(size_t j = 0; j < n; ++j)
+        b[j] = w[2*j+1];
+    }
+
+  } // namespace packing
+
+  /**
+   * Real 1D FFTs by complex FFTW transforms of packed real signals, to be
+   * compared with the native R2C/C2R transforms (Inplace_Real, Outplace_Real)
+   * of the same batch (--batch). The spectra have the layout of the native
+   * transforms (n/2+1 values, in-place signals padded to 2*(n/2+1) reals).
+   * - half: the even and odd samples of a signal are the real and imaginary
+   *   part of an n/2-point complex FFT (no copy), the spectrum is separated
+   *   by a post-processing pass with n/4 twiddles. Even sizes only.
+   * - pair: two signals of the batch are packed into real and imaginary part
+   *   of one n-point complex FFT and separated afterwards.
+   * The time of the complex FFTs and of the pre- and post-processing passes
+   * is recorded as StageFFT and StagePacking.
+   */
+  template<typename TFFT, // FFT_Inplace_Packed_Real or FFT_Outplace_Packed_Real
+           typename TPrecision, // double, float
+           size_t   NDim // 1
+           >
+  struct FftwPackedRealImpl
+  {
+    using Extent = std::array<std::size_t, NDim>;
+    using PlanAPI = typename traits::plan<TPrecision>;
+    using ComplexType = typename traits::plan<TPrecision>::ComplexType;
+    using RealType = typename traits::plan<TPrecision>::RealType;
+    using PlanType = typename traits::plan<TPrecision>::PlanType;
+    using MemoryAPI = typename traits::memory_api<TPrecision>;
+    using Strategy = packing::Strategy;
+
+    static_assert(!TFFT::IsComplex, "Packed real benchmarks are real transforms only.");
+
+    static constexpr bool IsInplace = TFFT::IsInplace;
+    static constexpr bool UsesHostMemory = true;
+
+    size_t n_ = 0;
+    /// complex values of a spectrum
+    size_t n_spectrum_ = 0;
+    Strategy strategy_ = Strategy::Half;
+    size_t batch_ = 1;
+    /// distance of consecutive real signals (padded for in-place)
+    size_t dist_ = 0;
+    size_t data_size_ = 0;
+    size_t data_complex_size_ = 0;
+    size_t work_size_ = 0;
+
+    RealType* data_ = nullptr;
+    ComplexType* data_complex_ = nullptr;
+    /// packed pairs of signals (pair strategy)
+    ComplexType* work_ = nullptr;
+
+    PlanType fwd_plan_ = nullptr;
+    PlanType bwd_plan_ = nullptr;
+    /// w^k = exp(-2*pi*i*k/n), k <= n/4 (half strategy)
+    std::vector<RealType> wr_;
+    std::vector<RealType> wi_;
+
+    /// time of the complex FFTs and of the packing passes of forward and inverse transform [ms]
+    double fft_time_ = 0.0;
+    double packing_time_ = 0.0;
+
+    FftwPackedRealImpl(const Extent& cextents) {
+      n_ = cextents[0];
+      n_spectrum_ = n_/2 + 1;
+      const auto& config = packing::selected();
+      strategy_ = config.strategy;
+      batch_ = config.batch;
+      dist_ = IsInplace ? 2*n_spectrum_ : n_;
+      data_size_ = traits::checked_size(batch_, dist_) * sizeof(RealType);
+      data_complex_size_ = traits::checked_size(batch_, n_spectrum_) * sizeof(ComplexType);
+      work_size_ = strategy_ == Strategy::Pair
+        ? traits::checked_size(pairs(), n_) * sizeof(ComplexType)
+        : 0;
+
+      if(FftwContext::fresh_planner())
+        FftwContext::init_planner<TPrecision>();
+    }
+
+    ~FftwPackedRealImpl() {
+      destroy();
+      if(FftwContext::fresh_planner())
+        FftwContext::cleanup_planner<TPrecision>();
+    }
+
+    /// packed real benchmarks of 1D extents are only run with --real-packing and native FFTW
+    static bool enabled() {
+      return NDim == 1 && native_fftw() && !FftwContext::options().packing_variants().empty();
+    }
+
+    /// strategies and batch sizes to be compared (--real-packing, --batch)
+    static std::vector<std::string> variants() {
+      return FftwContext::options().packing_variants();
+    }
+
+    static void select_variant(const std::string& variant) {
+      packing::select_variant(variant);
+    }
+
+    /// the half strategy splits a signal into even and odd samples
+    static std::string unsupported(const Extent& cextents) {
+      if(packing::selected().strategy == Strategy::Half && cextents[0] % 2 != 0)
+        return "half-length packing needs an even size";
+      return "";
+    }
+
+    std::vector<std::pair<RecordType, double> > get_stage_times() const {
+      return {{RecordType::StageFFT, fft_time_}, {RecordType::StagePacking, packing_time_}};
+    }
+
+    /// buffers of the selected strategy and batch, see FFT::footprint()
+    static FFTFootprint footprint(const Extent& cextents) {
+      const size_t n = cextents[0];
+      const size_t n_spectrum = n/2 + 1;
+      const auto& config = packing::selected();
+      FFTFootprint fp;
+      fp.allocation = traits::checked_size(config.batch, IsInplace ? 2*n_spectrum : n) * sizeof(RealType);
+      if(!IsInplace)
+        fp.allocation += traits::checked_size(config.batch, n_spectrum) * sizeof(ComplexType);
+      if(config.strategy == Strategy::Pair)
+        fp.allocation += traits::checked_size((config.batch + 1) / 2, n) * sizeof(ComplexType);
+      fp.transfer = n * sizeof(RealType);
+      return fp;
+    }
+
+    size_t get_allocation_size() {
+      return data_size_ + (IsInplace ? 0 : data_complex_size_) + work_size_;
+    }
+
+    /// twiddles of the half strategy
+    size_t get_plan_size() {
+      return (wr_.size() + wi_.size()) * sizeof(RealType);
+    }
+
+    /// transforms of a batch get the same data, the size refers to one transform
+    size_t get_transfer_size() {
+      return n_ * sizeof(RealType);
+    }
+
+    void init_forward() {
+      if(strategy_ == Strategy::Half)
+        init_twiddles();
+      fwd_plan_ = create_plan(traits::fftw_direction::forward);
+    }
+
+    void init_inverse() {
+      bwd_plan_ = create_plan(traits::fftw_direction::inverse);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    // --- next methods are benchmarked ---
+
+    void allocate() {
+      data_ = static_cast<RealType*>(MemoryAPI::malloc(data_size_));
+      data_complex_ = IsInplace ? reinterpret_cast<ComplexType*>(data_)
+                                : static_cast<ComplexType*>(MemoryAPI::malloc(data_complex_size_));
+      if(work_size_ > 0)
+        work_ = static_cast<ComplexType*>(MemoryAPI::malloc(work_size_));
+    }
+
+    void execute_forward() {
+      TimerCPU timer;
+      if(strategy_ == Strategy::Half) {
+        timer.startTimer();
+        PlanAPI::execute(fwd_plan_);
+        fft_time_ += timer.stopTimer();
+        timer.startTimer();
+        for(size_t s = 0; s < batch_; ++s)
+          packing::half_forward(spectrum(s), n_/2, wr_.data(), wi_.data());
+        packing_time_ += timer.stopTimer();
+      } else {
+        timer.startTimer();
+        for(size_t p = 0; p < pairs(); ++p)
+          packing::pair_pack(packed(p), signal(2*p), 2*p+1 < batch_ ? signal(2*p+1) : nullptr, n_);
+        packing_time_ += timer.stopTimer();
+        timer.startTimer();
+        PlanAPI::execute(fwd_plan_);
+        fft_time_ += timer.stopTimer();
+        timer.startTimer();
+        for(size_t p = 0; p < pairs(); ++p)
+          packing::pair_unpack(spectrum(2*p), 2*p+1 < batch_ ? spectrum(2*p+1) : nullptr, packed(p), n_);
+        packing_time_ += timer.stopTimer();
+      }
+    }
+
+    void execute_inverse() {
+      TimerCPU timer;
+      if(strategy_ == Strategy::Half) {
+        timer.startTimer();
+        for(size_t s = 0; s < batch_; ++s)
+          packing::half_inverse(spectrum(s), n_/2, wr_.data(), wi_.data());
+        packing_time_ += timer.stopTimer();
+        timer.startTimer();
+        PlanAPI::execute(bwd_plan_);
+        fft_time_ += timer.stopTimer();
+      } else {
+        timer.startTimer();
+        for(size_t p = 0; p < pairs(); ++p)
+          packing::pair_merge(packed(p), spectrum(2*p), 2*p+1 < batch_ ? spectrum(2*p+1) : nullptr, n_);
+        packing_time_ += timer.stopTimer();
+        timer.startTimer();
+        PlanAPI::execute(bwd_plan_);
+        fft_time_ += timer.stopTimer();
+        timer.startTimer();
+        for(size_t p = 0; p < pairs(); ++p)
+          packing::pair_split(signal(2*p), 2*p+1 < batch_ ? signal(2*p+1) : nullptr, packed(p), n_);
+        packing_time_ += timer.stopTimer();
+      }
+    }
+
+    /// copies the input to every signal of the batch
+    template<typename THostData>
+    void upload(THostData* input) {
+      for(size_t s = 0; s < batch_; ++s)
+        MemoryAPI::memcpy(signal(s), input, n_ * sizeof(RealType));
+    }
+
+    /// copies the first signal of the batch
+    template<typename THostData>
+    void download(THostData* output) {
+      MemoryAPI::memcpy(output, data_, n_ * sizeof(RealType));
+    }
+
+    void destroy() {
+      if(fwd_plan_)
+        PlanAPI::destroy(fwd_plan_);
+      fwd_plan_ = nullptr;
+      if(bwd_plan_)
+        PlanAPI::destroy(bwd_plan_);
+      bwd_plan_ = nullptr;
+
+      if(data_complex_ && !IsInplace)
+        MemoryAPI::free(data_complex_);
+      data_complex_ = nullptr;
+
+      if(data_)
+        MemoryAPI::free(data_);
+      data_ = nullptr;
+
+      if(work_)
+        MemoryAPI::free(work_);
+      work_ = nullptr;
+    }
+
+  private:
+
+    size_t pairs() const {
+      return (batch_ + 1) / 2;
+    }
+
+    RealType* signal(size_t s) const {
+      return data_ + s*dist_;
+    }
+
+    RealType* spectrum(size_t s) const {
+      return reinterpret_cast<RealType*>(data_complex_ + s*n_spectrum_);
+    }
+
+    RealType* packed(size_t p) const {
+      return reinterpret_cast<RealType*>(work_ + p*n_);
+    }
+
+    void init_twiddles() {
+      if(n_ % 2 != 0)
+        throw std::runtime_error("Half-length packing needs an even size, use --real-packing pair.");
+      const long double pi = 3.141592653589793238462643383279502884L;
+      const size_t h = n_/4 + 1;
+      wr_.resize(h);
+      wi_.resize(h);
+      for(size_t k = 0; k < h; ++k) {
+        const long double phi = -2 * pi * static_cast<long double>(k) / static_cast<long double>(n_);
+        wr_[k] = static_cast<RealType>(std::cos(phi));
+        wi_[k] = static_cast<RealType>(std::sin(phi));
+      }
+    }
+
+    /**
+     * half: batch of n/2-point FFTs, the real signals are read as complex values,
+     *       the spectra leave room for the value n/2.
+     * pair: batch of n-point FFTs of the packed pairs, in-place.
+     */
+    PlanType create_plan(traits::fftw_direction dir) {
+      const unsigned flags = FftwContext::options().plan_rigor();
+      traits::layout batch;
+      PlanType plan = nullptr;
+      if(strategy_ == Strategy::Half) {
+        const bool forward = dir == traits::fftw_direction::forward;
+        ComplexType* signals = reinterpret_cast<ComplexType*>(data_);
+        batch.howmany = batch_;
+        batch.in_dist = forward ? dist_/2 : n_spectrum_;
+        batch.out_dist = forward ? n_spectrum_ : dist_/2;
+        plan = PlanAPI::create(std::array<size_t, 1>{{n_/2}},
+                               forward ? signals : data_complex_,
+                               forward ? data_complex_ : signals,
+                               dir, flags, batch);
+      } else {
+        batch.howmany = pairs();
+        batch.in_dist = n_;
+        batch.out_dist = n_;
+        plan = PlanAPI::create(std::array<size_t, 1>{{n_}}, work_, work_, dir, flags, batch);
+      }
+      if(!plan)
+        throw std::runtime_error("fftw plan of a packed real transform could not be created.");
+      return plan;
+    }
+  };
+
+  using Inplace_Packed_Real = gearshifft::FFT<FFT_Inplace_Packed_Real,
+                                              FFT_Plan_Not_Reusable,
+                                              FftwPackedRealImpl,
+                                              TimerCPU>;
+
+  using Outplace_Packed_Real = gearshifft::FFT<FFT_Outplace_Packed_Real,
+                                               FFT_Plan_Not_Reusable,
+                                               FftwPackedRealImpl,
+                                               TimerCPU>;
+} // namespace fftw
+} // namespace gearshifft
+
+#endif /* FFTW_PACKED_HPP_ */
@@ -0,0 +1,284 @@
+#ifndef FFTW_ROWCOL_HPP_
+#define FFTW_ROWCOL_HPP_
+
+#include "fftw.hpp"
+#include "fftw_transpose.hpp"
+
+#include <algorithm>
+#include <array>
+#include <complex>
+#include <cstddef>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace gearshifft {
+namespace fftw {
+
+  namespace rowcol {
+
+    /// transpose configuration of the next benchmark runs, see FftwOptions::transpose_variants()
+    struct Config {
+      size_t block = 32;
+      /// 0 = FFTW threads
+      size_t threads = 0;
+    };
+
+    inline Config& selected() {
+      static Config config;
+      return config;
+    }
+
+    inline void select_variant(const std::string& variant) {
+      Config config;
+      std::stringstream ss(variant);
+      std::string token;
+      while(std::getline(ss, token, ';')) {
+        const auto pos = token.find('=');
+        const std::string key = token.substr(0, pos);
+        const std::string value = pos == std::string::npos ? "" : token.substr(pos+1);
+        if(key == "block")
+          config.block = std::stoul(value);
+        else if(key == "transpose-threads")
+          config.threads = std::stoul(value);
+        else
+          throw std::runtime_error("Invalid row-column variant '"+variant+"'.");
+      }
+      selected() = config;
+    }
+
+  } // namespace rowcol
+
+  /**
+   * Complex 2D/3D FFTs by row-column decomposition: every stage transforms the
+   * contiguous (last) axis by a batched 1D FFTW plan and transposes the array
+   * (rows x last axis), which rotates the axes. After one stage per dimension
+   * the axes are in their original order. The transposes are cache-blocked
+   * and multi-threaded (--transpose-block, --transpose-threads), the time of
+   * the 1D passes and the transposes is recorded as StageFFT and StageTranspose.
+   */
+  template<typename TFFT, // FFT_Inplace_RowColumn_Complex or FFT_Outplace_RowColumn_Complex
+           typename TPrecision, // double, float
+           size_t   NDim // 2..3
+           >
+  struct FftwRowColumnImpl
+  {
+    using Extent = std::array<std::size_t, NDim>;
+    using PlanAPI = typename traits::plan<TPrecision>;
+    using ComplexType = typename traits::plan<TPrecision>::ComplexType;
+    using RealType = typename traits::plan<TPrecision>::RealType;
+    using PlanType = typename traits::plan<TPrecision>::PlanType;
+    using MemoryAPI = typename traits::memory_api<TPrecision>;
+    using Value = std::complex<RealType>;
+
+    static_assert(TFFT::IsComplex, "Row-column benchmarks are complex transforms only.");
+
+    static constexpr bool IsInplace = TFFT::IsInplace;
+    static constexpr bool UsesHostMemory = true;
+
+    Extent extents_ = {{0}};
+    size_t n_ = 0;
+    size_t block_ = 32;
+    size_t threads_ = 1;
+
+    ComplexType* data_ = nullptr;
+    ComplexType* data_complex_ = nullptr;
+    ComplexType* work_ = nullptr;
+
+    /// batched 1D plans of the stages
+    std::array<PlanType, NDim> fwd_plans_ = {{nullptr}};
+    std::array<PlanType, NDim> bwd_plans_ = {{nullptr}};
+
+    /// time of the 1D passes and the transposes of forward and inverse transform [ms]
+    double fft_time_ = 0.0;
+    double transpose_time_ = 0.0;
+
+    FftwRowColumnImpl(const Extent& cextents) {
+      extents_ = interpret_as::column_major(cextents);
+      n_ = std::accumulate(extents_.begin(),
+                           extents_.end(),
+                           static_cast<size_t>(1),
+                           traits::checked_size);
+      const auto& config = rowcol::selected();
+      block_ = config.block;
+      threads_ = config.threads > 0 ? config.threads : std::max<size_t>(1, FftwContext::used_threads());
+
+      if(FftwContext::fresh_planner())
+        FftwContext::init_planner<TPrecision>();
+    }
+
+    ~FftwRowColumnImpl() {
+      destroy();
+      if(FftwContext::fresh_planner())
+        FftwContext::cleanup_planner<TPrecision>();
+    }
+
+    /// row-column benchmarks of 2D/3D extents are only run with --rowcol and native FFTW
+    static bool enabled() {
+      return NDim > 1 && native_fftw() && FftwContext::options().rowcol();
+    }
+
+    /// transpose configurations to be compared (--transpose-block, --transpose-threads)
+    static std::vector<std::string> variants() {
+      return FftwContext::options().transpose_variants();
+    }
+
+    static void select_variant(const std::string& variant) {
+      rowcol::select_variant(variant);
+    }
+
+    std::vector<std::pair<RecordType, double> > get_stage_times() const {
+      return {{RecordType::StageFFT, fft_time_}, {RecordType::StageTranspose, transpose_time_}};
+    }
+
+    /// data buffers and transpose buffer, see FFT::footprint()
+    static FFTFootprint footprint(const Extent& cextents) {
+      const size_t n = std::accumulate(cextents.begin(),
+                                       cextents.end(),
+                                       static_cast<size_t>(1),
+                                       traits::checked_size);
+      FFTFootprint fp;
+      fp.allocation = (IsInplace ? 2 : 3) * n * sizeof(ComplexType);
+      fp.transfer = n * sizeof(ComplexType);
+      return fp;
+    }
+
+    size_t get_allocation_size() {
+      return (IsInplace ? 2 : 3) * n_ * sizeof(ComplexType);
+    }
+
+    size_t get_plan_size() {
+      return 0;
+    }
+
+    size_t get_transfer_size() {
+      return n_ * sizeof(ComplexType);
+    }
+
+    void init_forward() {
+      create_plans(fwd_plans_, data_, data_complex_, traits::fftw_direction::forward);
+    }
+
+    void init_inverse() {
+      create_plans(bwd_plans_, data_complex_, data_, traits::fftw_direction::inverse);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    // --- next methods are benchmarked ---
+
+    void allocate() {
+      data_ = static_cast<ComplexType*>(MemoryAPI::malloc(n_ * sizeof(ComplexType)));
+      data_complex_ = IsInplace ? data_
+                                : static_cast<ComplexType*>(MemoryAPI::malloc(n_ * sizeof(ComplexType)));
+      work_ = static_cast<ComplexType*>(MemoryAPI::malloc(n_ * sizeof(ComplexType)));
+    }
+
+    void execute_forward() {
+      execute(fwd_plans_, data_complex_);
+    }
+
+    void execute_inverse() {
+      execute(bwd_plans_, data_);
+    }
+
+    template<typename THostData>
+    void upload(THostData* input) {
+      MemoryAPI::memcpy(data_, input, n_ * sizeof(ComplexType));
+    }
+
+    template<typename THostData>
+    void download(THostData* output) {
+      MemoryAPI::memcpy(output, data_, n_ * sizeof(ComplexType));
+    }
+
+    void destroy() {
+      for(size_t s = 0; s < NDim; ++s) {
+        if(fwd_plans_[s])
+          PlanAPI::destroy(fwd_plans_[s]);
+        fwd_plans_[s] = nullptr;
+        if(bwd_plans_[s])
+          PlanAPI::destroy(bwd_plans_[s]);
+        bwd_plans_[s] = nullptr;
+      }
+
+      if(data_complex_ && !IsInplace)
+        MemoryAPI::free(data_complex_);
+      data_complex_ = nullptr;
+
+      if(data_)
+        MemoryAPI::free(data_);
+      data_ = nullptr;
+
+      if(work_)
+        MemoryAPI::free(work_);
+      work_ = nullptr;
+    }
+
+  private:
+
+    /// length of the contiguous axis at stage s (axes rotate by one per stage)
+    size_t stage_length(size_t s) const {
+      return extents_[NDim-1-s];
+    }
+
+    /**
+     * Buffer holding the data after the 1D pass of stage s. The buffers
+     * alternate with every transpose, the last transpose writes to dst.
+     */
+    ComplexType* stage_buffer(size_t s, ComplexType* dst) const {
+      const bool on_dst = (NDim - s) % 2 == 0;
+      return on_dst ? dst : work_;
+    }
+
+    void create_plans(std::array<PlanType, NDim>& plans,
+                      ComplexType* src,
+                      ComplexType* dst,
+                      traits::fftw_direction dir) {
+      const unsigned flags = FftwContext::options().plan_rigor();
+      for(size_t s = 0; s < NDim; ++s) {
+        const size_t len = stage_length(s);
+        traits::layout lines;
+        lines.howmany = n_ / len;
+        lines.in_dist = len;
+        lines.out_dist = len;
+        ComplexType* out = stage_buffer(s, dst);
+        ComplexType* in = s == 0 ? src : out;
+        plans[s] = PlanAPI::create(std::array<size_t, 1>{{len}}, in, out, dir, flags, lines);
+        if(!plans[s])
+          throw std::runtime_error("fftw plan of a row-column stage could not be created.");
+      }
+    }
+
+    void execute(const std::array<PlanType, NDim>& plans, ComplexType* dst) {
+      TimerCPU timer;
+      for(size_t s = 0; s < NDim; ++s) {
+        const size_t len = stage_length(s);
+        ComplexType* cur = stage_buffer(s, dst);
+        ComplexType* next = cur == work_ ? dst : work_;
+        timer.startTimer();
+        PlanAPI::execute(plans[s]);
+        fft_time_ += timer.stopTimer();
+        timer.startTimer();
+        transpose_blocked(reinterpret_cast<const Value*>(cur), reinterpret_cast<Value*>(next),
+                          n_ / len, len, block_, threads_);
+        transpose_time_ += timer.stopTimer();
+      }
+    }
+  };
+
+  using Inplace_RowColumn_Complex = gearshifft::FFT<FFT_Inplace_RowColumn_Complex,
+                                                    FFT_Plan_Not_Reusable,
+                                                    FftwRowColumnImpl,
+                                                    TimerCPU>;
+
+  using Outplace_RowColumn_Complex = gearshifft::FFT<FFT_Outplace_RowColumn_Complex,
+                                                     FFT_Plan_Not_Reusable,
+                                                     FftwRowColumnImpl,
+                                                     TimerCPU>;
+} // namespace fftw
+} // namespace gearshifft
+
+#endif /* FFTW_ROWCOL_HPP_ */
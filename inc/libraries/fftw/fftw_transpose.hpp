@@ -0,0 +1,47 @@
+#ifndef FFTW_TRANSPOSE_HPP_
+#define FFTW_TRANSPOSE_HPP_
+
+#include "core/parallel.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace gearshifft {
+namespace fftw {
+
+  /**
+   * Out-of-place transpose of a row-major rows x cols matrix by square tiles
+   * of block x block elements (dst[c*rows + r] = src[r*cols + c]). Tiles are
+   * numbered column-major, so consecutive tiles write to the same rows of dst,
+   * and contiguous ranges of tiles are distributed to the threads.
+   */
+  template<typename T>
+  void transpose_blocked(const T* src, T* dst,
+                         size_t rows, size_t cols,
+                         size_t block, size_t threads) {
+    block = std::max<size_t>(block, 1);
+    const size_t row_tiles = (rows + block - 1) / block;
+    const size_t col_tiles = (cols + block - 1) / block;
+    const size_t tiles = row_tiles * col_tiles;
+    auto transpose_tiles = [=](size_t, size_t begin, size_t end) {
+      for(size_t t = begin; t < end; ++t) {
+        const size_t r0 = (t % row_tiles) * block;
+        const size_t c0 = (t / row_tiles) * block;
+        const size_t r1 = std::min(rows, r0 + block);
+        const size_t c1 = std::min(cols, c0 + block);
+        for(size_t c = c0; c < c1; ++c)
+          for(size_t r = r0; r < r1; ++r)
+            dst[c*rows + r] = src[r*cols + c];
+      }
+    };
+    threads = std::max<size_t>(1, std::min(threads, tiles));
+    if(threads == 1)
+      transpose_tiles(0, 0, tiles);
+    else
+      parallel::for_each_chunk(tiles, threads, transpose_tiles);
+  }
+
+} // namespace fftw
+} // namespace gearshifft
+
+#endif /* FFTW_TRANSPOSE_HPP_ */
@@ -0,0 +1,243 @@
+#ifndef FFTW_WISDOM_HPP_
+#define FFTW_WISDOM_HPP_
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+#ifdef USE_ESSL
+#include <fftw3_essl.h>
+#else
+#include <fftw3.h>
+#endif
+
+namespace gearshifft {
+namespace fftw {
+
+  namespace traits {
+
+    template <typename T>
+    struct wisdom_api {};
+
+#ifndef USE_ESSL
+    template <>
+    struct wisdom_api<float> {
+      static const char* suffix() { return "sp"; }
+      static int import_file(const char* fname) { return fftwf_import_wisdom_from_filename(fname); }
+      static int export_file(const char* fname) { return fftwf_export_wisdom_to_filename(fname); }
+      static void forget() { fftwf_forget_wisdom(); }
+    };
+
+    template <>
+    struct wisdom_api<double> {
+      static const char* suffix() { return "dp"; }
+      static int import_file(const char* fname) { return fftw_import_wisdom_from_filename(fname); }
+      static int export_file(const char* fname) { return fftw_export_wisdom_to_filename(fname); }
+      static void forget() { fftw_forget_wisdom(); }
+    };
+#endif
+  } // namespace traits
+
+  namespace wisdom {
+
+    /// replaces characters not suitable for file names
+    inline std::string sanitize(const std::string& str) {
+      std::string result;
+      for(char c : str) {
+        if(std::isalnum(static_cast<unsigned char>(c)) || c=='.' || c=='-')
+          result += c;
+        else if(!result.empty() && result.back()!='_')
+          result += '_';
+      }
+      while(!result.empty() && result.back()=='_')
+        result.pop_back();
+      return result.empty() ? "unknown" : result;
+    }
+
+    /// CPU model name from /proc/cpuinfo (x86: model name, ARM: CPU implementer/part)
+    inline std::string cpu_model() {
+      std::string model;
+#if defined(__linux__)
+      std::ifstream fs("/proc/cpuinfo");
+      std::string line;
+      std::string implementer;
+      std::string part;
+      while(std::getline(fs, line)) {
+        auto pos = line.find(':');
+        if(pos == std::string::npos)
+          continue;
+        std::string key = line.substr(0, line.find_last_not_of(" \t", pos-1)+1);
+        std::string value = line.substr(std::min(line.size(), pos+2));
+        if(key == "model name") {
+          model = value;
+          break;
+        }
+        if(key == "CPU implementer" && implementer.empty())
+          implementer = value;
+        if(key == "CPU part" && part.empty())
+          part = value;
+      }
+      if(model.empty() && !implementer.empty())
+        model = "arm-" + implementer + "-" + part;
+#endif
+      return sanitize(model);
+    }
+
+    /// creates directory if it does not exist
+    inline void make_directory(const std::string& dir) {
+#if defined(__unix__) || defined(__APPLE__)
+      struct stat st;
+      if(stat(dir.c_str(), &st) == 0) {
+        if(!S_ISDIR(st.st_mode))
+          throw std::runtime_error("Wisdom cache '"+dir+"' is not a directory.");
+        return;
+      }
+      if(mkdir(dir.c_str(), 0755) != 0)
+        throw std::runtime_error("Wisdom cache directory '"+dir+"' could not be created.");
+#else
+      static_cast<void>(dir);
+#endif
+    }
+
+    inline bool file_exists(const std::string& fname) {
+      return std::ifstream(fname).good();
+    }
+
+    /// unique suffix for temporary files
+    inline std::string tmp_suffix() {
+      std::stringstream ss;
+#if defined(__unix__) || defined(__APPLE__)
+      ss << ".tmp." << getpid();
+#else
+      ss << ".tmp";
+#endif
+      return ss.str();
+    }
+
+    /// exports the current wisdom to a temporary file and renames it to fname
+    template<typename T_Precision>
+    void export_atomic(const std::string& fname) {
+      const std::string tmp = fname + tmp_suffix();
+      if(!traits::wisdom_api<T_Precision>::export_file(tmp.c_str())
+         || std::rename(tmp.c_str(), fname.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        throw std::runtime_error("Wisdom file '"+fname+"' could not be written.");
+      }
+    }
+
+    /**
+     * Host-keyed FFTW wisdom cache of a precision.
+     *
+     * Wisdom is stored in <dir>/<cpu model>_<fftw version>_t<threads>_<sp|dp>.wisdom,
+     * imported by import() and written back by save(). Planned problems are
+     * counted as hits (plan could be created from wisdom) or misses.
+     */
+    template<typename T_Precision>
+    class Cache {
+    public:
+      static Cache& instance() {
+        static Cache cache;
+        return cache;
+      }
+
+      /// file name of the wisdom for this host, FFTW version and number of threads
+      static std::string filename(const std::string& dir, int nthreads) {
+        std::stringstream ss;
+        ss << dir << "/" << cpu_model()
+           << "_" << sanitize(version())
+           << "_t" << nthreads
+           << "_" << traits::wisdom_api<T_Precision>::suffix()
+           << ".wisdom";
+        return ss.str();
+      }
+
+      /// enables the cache, creates cache directory if needed
+      void open(const std::string& dir, int nthreads) {
+        std::lock_guard<std::mutex> g(mutex_);
+        make_directory(dir);
+        file_ = filename(dir, nthreads);
+        enabled_ = true;
+      }
+
+      /// imports the wisdom of the cache (FFTW threads must be initialized before)
+      void import() {
+        std::lock_guard<std::mutex> g(mutex_);
+        if(file_exists(file_) && !traits::wisdom_api<T_Precision>::import_file(file_.c_str()))
+          throw std::runtime_error("Wisdom file '"+file_+"' could not be loaded.");
+      }
+
+      bool enabled() const {
+        return enabled_;
+      }
+
+      const std::string& file() const {
+        return file_;
+      }
+
+      void hit() {
+        std::lock_guard<std::mutex> g(mutex_);
+        ++hits_;
+      }
+
+      void miss() {
+        std::lock_guard<std::mutex> g(mutex_);
+        ++misses_;
+        dirty_ = true;
+      }
+
+      size_t hits() const {
+        return hits_;
+      }
+
+      size_t misses() const {
+        return misses_;
+      }
+
+      /**
+       * Writes wisdom back if problems have been planned since the last save.
+       * Wisdom of concurrent runs in the meantime is merged, the file is
+       * replaced atomically (rename).
+       */
+      void save() {
+        std::lock_guard<std::mutex> g(mutex_);
+        if(!enabled_ || !dirty_)
+          return;
+        if(file_exists(file_))
+          traits::wisdom_api<T_Precision>::import_file(file_.c_str());
+        export_atomic<T_Precision>(file_);
+        dirty_ = false;
+      }
+
+    private:
+      Cache() = default;
+
+      /// FFTW version, e.g. fftw-3.3.8-sse2
+      static const char* version() {
+        return std::is_same<T_Precision, float>::value ? fftwf_version : fftw_version;
+      }
+
+      std::mutex mutex_;
+      std::string file_;
+      bool enabled_ = false;
+      bool dirty_ = false;
+      size_t hits_ = 0;
+      size_t misses_ = 0;
+    };
+
+  } // namespace wisdom
+} // namespace fftw
+} // namespace gearshifft
+
+#endif /* FFTW_WISDOM_HPP_ */
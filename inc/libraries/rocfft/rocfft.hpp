@@ -200,6 +200,11 @@ namespace RocFFT {
       CHECK_HIP(rocfft_cleanup());
     }
 
+    /// buffer sizes without creating a plan or setting up rocFFT, see FFT::footprint()
+    static FFTFootprint footprint(const Extent& cextents) {
+      return dense_footprint<IsComplex, IsInplace>(cextents, sizeof(RealType));
+    }
+
     /**
      * Returns allocated memory on device for FFT
      */
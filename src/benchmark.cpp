@@ -6,6 +6,8 @@
 // ----------------------------------------------------------------------------
 template<typename... Types>
 using List = gearshifft::List<Types...>;
+template<typename T_List1, typename T_List2>
+using JoinedList = gearshifft::JoinedList<T_List1, T_List2>;
 
 #ifdef CUFFT_ENABLED
 #include "libraries/cufft/cufft.hpp"
@@ -32,15 +34,61 @@ using FFTs              = List<Inplace_Real,
 using Precisions        = gearshifft::DefaultPrecisionsWithoutHalfPrecision;
 using FFT_Is_Normalized = std::true_type;
 
+#elif defined(FFTW_MPI_ENABLED)
+#include "libraries/fftw/fftw_mpi.hpp"
+
+using namespace gearshifft::fftw_mpi;
+using Context           = FftwMpiContext;
+// 1D transforms are not distributed (2D and 3D extents only)
+using FFTs              = List<Inplace_Real,
+                               Inplace_Complex,
+                               Outplace_Real,
+                               Outplace_Complex >;
+using Precisions        = gearshifft::DefaultPrecisionsWithoutHalfPrecision;
+using FFT_Is_Normalized = std::false_type;
+
 #elif defined(FFTW_ENABLED)
 #include "libraries/fftw/fftw.hpp"
+#ifndef USE_ESSL
+#include "libraries/fftw/fftw_bluestein.hpp"
+#include "libraries/fftw/fftw_rowcol.hpp"
+#include "libraries/fftw/fftw_fourstep.hpp"
+#include "libraries/fftw/fftw_packed.hpp"
+#endif
 
 using namespace gearshifft::fftw;
 using Context           = FftwContext;
+#ifndef USE_ESSL
+// R2R, axis-wise, split, Bluestein, row-column, four-step, packed real and convolution benchmarks are
+// registered with --r2r, --axes, --split, --bluestein, --rowcol, --four-step, --real-packing or --convolution only
+using FFTs              = JoinedList<List<Inplace_Real,
+                                          Inplace_Complex,
+                                          Outplace_Real,
+                                          Outplace_Complex,
+                                          Inplace_R2R,
+                                          Outplace_R2R,
+                                          Inplace_Axes_Complex,
+                                          Outplace_Axes_Complex,
+                                          Inplace_Split_Complex,
+                                          Outplace_Split_Complex,
+                                          Inplace_Bluestein_Complex,
+                                          Outplace_Bluestein_Complex >,
+                                     List<Inplace_RowColumn_Complex,
+                                          Outplace_RowColumn_Complex,
+                                          Inplace_FourStep_Complex,
+                                          Outplace_FourStep_Complex,
+                                          Inplace_Packed_Real,
+                                          Outplace_Packed_Real,
+                                          Inplace_Convolution_Real,
+                                          Inplace_Convolution_Complex,
+                                          Outplace_Convolution_Real,
+                                          Outplace_Convolution_Complex > >;
+#else
 using FFTs              = List<Inplace_Real,
                                Inplace_Complex,
                                Outplace_Real,
                                Outplace_Complex >;
+#endif
 using Precisions        = gearshifft::DefaultPrecisionsWithoutHalfPrecision;
 using FFT_Is_Normalized = std::false_type;
 #elif defined(ROCFFT_ENABLED)
@@ -54,6 +102,17 @@ using FFTs              = List<Inplace_Real,
                                Outplace_Complex >;
 using Precisions        = List<float, double>;
 using FFT_Is_Normalized = std::false_type;
+#elif defined(BUILTIN_ENABLED)
+#include "libraries/builtin/builtin.hpp"
+
+using namespace gearshifft::builtin;
+using Context           = BuiltinContext;
+using FFTs              = List<Inplace_Real,
+                               Inplace_Complex,
+                               Outplace_Real,
+                               Outplace_Complex >;
+using Precisions        = gearshifft::DefaultPrecisionsWithoutHalfPrecision;
+using FFT_Is_Normalized = std::false_type;
 #endif
 
 // ----------------------------------------------------------------------------
@@ -0,0 +1,346 @@
+/**
+ * gearshifft_fftw_wisdom - generates FFTW wisdom for all extents of
+ * gearshifft extents files in parallel worker processes.
+ *
+ * All FFT kinds (in-/outplace, real/complex) of the requested precisions are
+ * planned by FftwImpl, i.e. exactly like in gearshifft_fftw. The problems are
+ * distributed dynamically over worker processes, which are pinned to separate
+ * cores. The wisdom of the workers is merged into the wisdom cache
+ * (--wisdom-cache) or into the files given by --wisdom_sp/--wisdom_dp.
+ * The planning time of every problem is logged (--log).
+ */
+#include "libraries/fftw/fftw.hpp"
+#include "core/timer_cpu.hpp"
+#include "gearshifft_version.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace gearshifft;
+using namespace gearshifft::fftw;
+namespace po = boost::program_options;
+
+namespace {
+
+  /// FFT problem to be planned
+  struct Problem {
+    bool double_precision;
+    int kind; // 0..3 = Inplace_Real, Outplace_Real, Inplace_Complex, Outplace_Complex
+    size_t ndim;
+    std::array<size_t,3> extents;
+
+    size_t size() const {
+      size_t n = 1;
+      for(size_t k=0; k<ndim; ++k)
+        n *= extents[k];
+      return n;
+    }
+  };
+
+  const char* kind_title(int kind) {
+    switch(kind) {
+    case 0: return FFT_Inplace_Real::Title;
+    case 1: return FFT_Outplace_Real::Title;
+    case 2: return FFT_Inplace_Complex::Title;
+    default: return FFT_Outplace_Complex::Title;
+    }
+  }
+
+  /// plans forward and inverse transform, times in ms
+  template<typename T_FFT, typename T_Precision, size_t NDim>
+  void plan(const Problem& p, size_t budget, double& time_fwd, double& time_inv) {
+    std::array<size_t,NDim> extents;
+    std::copy(p.extents.begin(), p.extents.begin()+NDim, extents.begin());
+    FftwImpl<T_FFT, T_Precision, NDim> fft(extents);
+    if(fft.get_allocation_size() > budget)
+      throw std::runtime_error("Skipped: memory");
+    fft.allocate();
+    TimerCPU timer;
+    timer.startTimer();
+    fft.init_forward();
+    time_fwd = timer.stopTimer();
+    timer.startTimer();
+    fft.init_inverse();
+    time_inv = timer.stopTimer();
+  }
+
+  template<typename T_FFT, typename T_Precision>
+  void plan_dim(const Problem& p, size_t budget, double& time_fwd, double& time_inv) {
+    switch(p.ndim) {
+    case 1: plan<T_FFT, T_Precision, 1>(p, budget, time_fwd, time_inv); break;
+    case 2: plan<T_FFT, T_Precision, 2>(p, budget, time_fwd, time_inv); break;
+    default: plan<T_FFT, T_Precision, 3>(p, budget, time_fwd, time_inv); break;
+    }
+  }
+
+  template<typename T_Precision>
+  void plan_kind(const Problem& p, size_t budget, double& time_fwd, double& time_inv) {
+    switch(p.kind) {
+    case 0: plan_dim<FFT_Inplace_Real, T_Precision>(p, budget, time_fwd, time_inv); break;
+    case 1: plan_dim<FFT_Outplace_Real, T_Precision>(p, budget, time_fwd, time_inv); break;
+    case 2: plan_dim<FFT_Inplace_Complex, T_Precision>(p, budget, time_fwd, time_inv); break;
+    default: plan_dim<FFT_Outplace_Complex, T_Precision>(p, budget, time_fwd, time_inv); break;
+    }
+  }
+
+  template<typename T_Extents>
+  void add_problems(std::vector<Problem>& problems,
+                    const std::vector<T_Extents>& extents,
+                    bool double_precision) {
+    for(const auto& e : extents) {
+      for(int kind=0; kind<4; ++kind) {
+        Problem p{double_precision, kind, e.size(), {{1,1,1}}};
+        std::copy(e.begin(), e.end(), p.extents.begin());
+        problems.push_back(p);
+      }
+    }
+  }
+
+  /// pins the calling process to the worker's share of the allowed cores
+  void pin_to_cores(size_t worker, size_t nthreads) {
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if(sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+      return;
+    std::vector<int> cpus;
+    for(int c=0; c<CPU_SETSIZE; ++c)
+      if(CPU_ISSET(c, &allowed))
+        cpus.push_back(c);
+    if(cpus.empty())
+      return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for(size_t k=0; k<nthreads; ++k)
+      CPU_SET(cpus[(worker*nthreads+k) % cpus.size()], &set);
+    sched_setaffinity(0, sizeof(set), &set);
+#else
+    static_cast<void>(worker);
+    static_cast<void>(nthreads);
+#endif
+  }
+
+  std::string worker_file(const std::string& prefix, size_t worker, const std::string& suffix) {
+    std::stringstream ss;
+    ss << prefix << ".worker" << worker << suffix;
+    return ss.str();
+  }
+
+  /// plans problems claimed from the shared counter next, returns exit code
+  int run_worker(size_t worker,
+                 size_t nthreads,
+                 const std::vector<Problem>& problems,
+                 std::atomic<size_t>* next,
+                 const std::string& prefix,
+                 size_t budget,
+                 bool sp,
+                 bool dp) {
+    pin_to_cores(worker, nthreads);
+    int ret = 0;
+    try {
+      FftwContext context;
+      context.create();
+
+      std::ofstream log(worker_file(prefix, worker, ".csv"));
+      for(size_t i = next->fetch_add(1); i < problems.size(); i = next->fetch_add(1)) {
+        const Problem& p = problems[i];
+        double time_fwd = 0.0;
+        double time_inv = 0.0;
+        std::string status = "Success";
+        try {
+          if(p.double_precision)
+            plan_kind<double>(p, budget, time_fwd, time_inv);
+          else
+            plan_kind<float>(p, budget, time_fwd, time_inv);
+        } catch(const std::runtime_error& e) {
+          status = e.what();
+        }
+        log << "\"" << (p.double_precision ? "double" : "float") << "\""
+            << ",\"" << kind_title(p.kind) << "\""
+            << "," << p.ndim
+            << "," << p.extents[0] << "," << p.extents[1] << "," << p.extents[2]
+            << "," << time_fwd << "," << time_inv
+            << "," << worker
+            << ",\"" << status << "\"\n" << std::flush;
+      }
+      if(sp)
+        wisdom::export_atomic<float>(worker_file(prefix, worker, ".sp.wisdom"));
+      if(dp)
+        wisdom::export_atomic<double>(worker_file(prefix, worker, ".dp.wisdom"));
+    } catch(const std::exception& e) {
+      std::cerr << "Worker " << worker << ": " << e.what() << std::endl;
+      ret = 1;
+    }
+    return ret;
+  }
+
+  /// imports worker wisdom and existing wisdom of fname, writes merged wisdom to fname
+  template<typename T_Precision>
+  void merge(const std::string& fname, const std::string& prefix, size_t nworkers, const char* suffix) {
+    if(wisdom::file_exists(fname))
+      traits::wisdom_api<T_Precision>::import_file(fname.c_str());
+    for(size_t w=0; w<nworkers; ++w) {
+      const std::string wfile = worker_file(prefix, w, suffix);
+      if(wisdom::file_exists(wfile)) {
+        if(!traits::wisdom_api<T_Precision>::import_file(wfile.c_str()))
+          std::cerr << "Warning: wisdom of worker " << w << " could not be imported." << std::endl;
+        std::remove(wfile.c_str());
+      }
+    }
+    wisdom::export_atomic<T_Precision>(fname);
+    std::cout << "Wisdom written to " << fname << std::endl;
+  }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  size_t jobs = 0;
+  std::string logfile;
+  auto& options = FftwContext::options();
+  options.add_options()
+    ("jobs,j", po::value<size_t>(&jobs)->default_value(0), "Number of worker processes (0 = number of cores / threads per plan)")
+    ("log", po::value<std::string>(&logfile)->default_value("wisdom_plantimes.csv"), "Planning time per problem (csv)");
+
+  try {
+    std::vector<char*> vargv(argv, argv+argc);
+    std::vector<char*> boost_vargv;
+    const int parsed = options.parse(vargv, boost_vargv);
+    if(parsed == 1) {
+      if(options.getVersion())
+        std::cout << "gearshifft " << gearshifft_version() << '\n';
+      else
+        std::cout << "gearshifft_fftw_wisdom " << gearshifft_version() << '\n'
+                  << "Generates FFTW wisdom for the extents of gearshifft_fftw (-e, -f).\n"
+                  << "Set threads per plan by -n, rigor by --rigor and output by --wisdom-cache or --wisdom_sp/--wisdom_dp.\n"
+                  << options.getDescription();
+      return 0;
+    } else if(parsed != 0) {
+      return 1;
+    }
+    if(!native_fftw())
+      throw std::runtime_error("Wisdom is only supported by native fftw, unable to proceed");
+    if(options.fresh_planner())
+      throw std::runtime_error("--fresh-planner would forget the wisdom between problems.");
+    if(options.plan_rigors().size() > 1)
+      throw std::runtime_error("Only a single rigor can be used to generate wisdom.");
+    if(options.plan_rigor() == FFTW_WISDOM_ONLY)
+      throw std::runtime_error("Rigor 'wisdom' cannot generate wisdom, use measure, patient or exhaustive.");
+
+    const bool cache = !options.wisdom_cache().empty();
+    const std::string wisdom_sp = options.wisdom_file<float>();
+    const std::string wisdom_dp = options.wisdom_file<double>();
+    const bool sp = cache || !wisdom_sp.empty();
+    const bool dp = cache || !wisdom_dp.empty();
+    if(!sp && !dp)
+      throw std::runtime_error("No wisdom output given (--wisdom-cache, --wisdom_sp or --wisdom_dp).");
+
+    std::vector<Problem> problems;
+    for(bool double_precision : {false, true}) {
+      if(double_precision ? !dp : !sp)
+        continue;
+      add_problems(problems, options.getExtents1D(), double_precision);
+      add_problems(problems, options.getExtents2D(), double_precision);
+      add_problems(problems, options.getExtents3D(), double_precision);
+    }
+    // large problems first for better load balance
+    std::stable_sort(problems.begin(), problems.end(),
+                     [](const Problem& a, const Problem& b) { return a.size() > b.size(); });
+
+    const size_t nthreads = std::max<size_t>(1, FftwContext::used_threads());
+    if(jobs == 0)
+      jobs = std::max<size_t>(1, std::max<size_t>(1, std::thread::hardware_concurrency()) / nthreads);
+    jobs = std::max<size_t>(1, std::min(jobs, problems.size()));
+    const size_t budget = options.getMemoryBudget() / jobs;
+    const std::string prefix = logfile + wisdom::tmp_suffix();
+
+    std::cout << "Planning " << problems.size() << " problems with rigor " << options.plan_rigor_str()
+              << " on " << jobs << " workers with " << nthreads << " thread(s) each." << std::endl;
+
+    // shared counter of the next problem to be planned
+    void* shared = mmap(nullptr, sizeof(std::atomic<size_t>), PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if(shared == MAP_FAILED)
+      throw std::runtime_error("Shared memory for worker processes could not be allocated.");
+    auto next = new (shared) std::atomic<size_t>(0);
+
+    TimerCPU timer;
+    timer.startTimer();
+    // FFTW must not be initialized before fork(), so workers set up their own planner
+    std::vector<pid_t> workers;
+    for(size_t w=0; w<jobs; ++w) {
+      std::cout << std::flush;
+      pid_t pid = fork();
+      if(pid < 0)
+        throw std::runtime_error("Worker process could not be created.");
+      if(pid == 0) {
+        _exit(run_worker(w, nthreads, problems, next, prefix, budget, sp, dp));
+      }
+      workers.push_back(pid);
+    }
+    int failed = 0;
+    for(pid_t pid : workers) {
+      int status = 0;
+      waitpid(pid, &status, 0);
+      if(!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        ++failed;
+    }
+    const double time_wall = timer.stopTimer();
+    munmap(shared, sizeof(std::atomic<size_t>));
+
+    // merge per-problem planning times
+    std::ofstream log(logfile);
+    log << "\"precision\",\"kind\",\"dim\",\"nx\",\"ny\",\"nz\""
+        << ",\"Time_PlanInitFwd [ms]\",\"Time_PlanInitInv [ms]\",\"worker\",\"success\"\n";
+    double time_plan = 0.0;
+    for(size_t w=0; w<jobs; ++w) {
+      const std::string wlog = worker_file(prefix, w, ".csv");
+      std::ifstream fs(wlog);
+      std::string line;
+      while(std::getline(fs, line)) {
+        log << line << "\n";
+        std::stringstream ss(line);
+        std::string token;
+        for(int col=0; col<8 && std::getline(ss, token, ','); ++col)
+          if(col >= 6)
+            time_plan += std::stod(token);
+      }
+      fs.close();
+      std::remove(wlog.c_str());
+    }
+    std::cout << "Planning times written to " << logfile
+              << " (sum " << time_plan/1000.0 << " s, wall " << time_wall/1000.0 << " s)" << std::endl;
+
+    // merge wisdom of the workers
+    FftwContext context;
+    context.create();
+    if(sp)
+      merge<float>(cache ? wisdom::Cache<float>::instance().file() : wisdom_sp, prefix, jobs, ".sp.wisdom");
+    if(dp)
+      merge<double>(cache ? wisdom::Cache<double>::instance().file() : wisdom_dp, prefix, jobs, ".dp.wisdom");
+
+    if(failed) {
+      std::cerr << failed << " worker(s) failed." << std::endl;
+      return 1;
+    }
+  } catch(const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -1,5 +1,7 @@
 #include "core/application.hpp"
 #include "core/options.hpp"
+#include "core/get_memory_size.hpp"
+#include "core/padding_advisor.hpp"
 
 #include <gearshifft_version.hpp>
 
@@ -18,7 +20,7 @@ OptionsDefault::OptionsDefault() {
   add_options()
     ("help,h", "Print help messages")
     ("extent,e", po::value<std::vector<std::string>>()->multitoken()->
-     composing(), "Specific extent (eg. 1024x1024) [>=1 nr. of args possible]")
+     composing(), "Specific extent (eg. 1024x1024, or 1024x1024:0.5 with a planning time budget in seconds) [>=1 nr. of args possible]")
     ("file,f", po::value<std::vector<std::string>>()->multitoken()->
      composing(), "File with extents (row-wise csv) [>=1 nr. of args possible]")
     ("output,o", po::value<std::string>(&outputFile_)->default_value("result.csv"), "output csv file, will be overwritten!")
@@ -27,6 +29,20 @@ OptionsDefault::OptionsDefault() {
     ("version,V", "Prints gearshifft version")
     ("device,d", po::value<std::string>(&device_)->default_value("gpu"), "Compute device = (gpu|cpu|acc|<ID>). If device is not supported by FFT lib, then it is ignored and default is used.")
     ("ndevices,n", po::value<size_t>(&ndevices_)->default_value(0), "Number of devices (0=all), if supported by FFT lib (e.g. clfft and fftw with n CPU threads).")
+    ("memory-budget", po::value<std::string>()->default_value("auto"), "Host memory budget per benchmark (e.g. 512M, 16G or bytes). Benchmarks exceeding it are skipped. auto = 95% of memory available at startup (cgroup-aware).")
+    ("dry-run", "Do not run benchmarks, print predicted memory and runtime of each benchmark instead")
+    ("max-bytes", po::value<std::string>(), "Skip benchmarks with a larger predicted memory footprint (e.g. 2G)")
+    ("max-predicted-time", po::value<double>(&maxPredictedTime_)->default_value(0.0), "Skip benchmarks with a larger predicted runtime in seconds (0 = no limit)")
+    ("predict-from", po::value<std::string>(&predictFrom_), "Previous result file (csv) for runtime prediction, otherwise a N*log(N) model is used")
+    ("data-cache", po::value<std::string>()->default_value("auto"), "Memory limit for cached test data of previous extents (e.g. 1G, 0 = keep current data only). auto = 25% of memory budget.")
+    ("ftz-daz", po::value<std::string>(&ftzDaz_)->default_value("off"), "Flush subnormals to zero (FTZ/DAZ) on benchmark and worker threads (off, on or both = each benchmark with and without)")
+    ("validate", po::value<std::string>()->default_value("every"), "Validation of FFT results (every = all runs, first-last = first and last run only, strided or random = sample of elements in every run)")
+    ("validate-confidence", po::value<double>()->default_value(0.99, "0.99"), "Probability to detect a mismatch rate >= validate-rate by a sample")
+    ("validate-rate", po::value<double>()->default_value(1e-4, "0.0001"), "Mismatch rate (fraction of elements) to be detected by a sample")
+    ("tuning-table", po::value<std::string>(&tuningTable_), "Write transform time of every configuration (benchmark variant) per extent to this csv file, the fastest is flagged")
+    ("prune", po::value<double>(&pruneFactor_)->default_value(0.0), "Stop a benchmark variant after the first warm run, if it is slower than factor times the best variant so far, e.g. 2 (default: 0 = no pruning)")
+    ("advise-padding", po::value<double>(&advisePadding_)->implicit_value(0.1, "0.1"), "Benchmark every dimension which is not a power of two also zero-padded to the sizes 2^a*3^b*5^c*7^d within +ratio (e.g. 0.1 = +10%) and report the fastest padded size per dimension")
+    ("convolution", po::bool_switch(&convolution_), "Run the convolution benchmarks (*_Convolution_Real, *_Convolution_Complex) of back-ends which expose their spectrum: forward transform, pointwise multiply by a cached kernel spectrum and inverse transform, validated by the direct convolution")
     ("list-devices,l", "List of available compute devices with IDs, if supported.")
     ("list-benchmarks,b", "Show registered benchmarks")
     ("run-benchmarks,r", po::value<std::string>(), "Run specific benchmarks (wildcards possible, e.g. ClFFT/float/*/Inplace_Real)")
@@ -39,6 +55,47 @@ OptionsDefault::~OptionsDefault() {
 }
 
 
+/// 95% of the available memory, keep some memory available, otherwise an out-of-memory killer becomes more likely
+static long long autoMemoryBudget() {
+  return static_cast<long long>(95*getAvailableMemorySize()/100);
+}
+
+size_t OptionsDefault::getMemoryBudget() const {
+  if(memoryBudget_ < 0) // options have not been parsed
+    return static_cast<size_t>(autoMemoryBudget());
+  return static_cast<size_t>(memoryBudget_);
+}
+
+size_t OptionsDefault::getDataCacheLimit() const {
+  if(dataCache_ >= 0)
+    return static_cast<size_t>(dataCache_);
+  return getMemoryBudget()/4;
+}
+
+/// parses sizes like 4096, 512K, 64M, 16G, 1T (binary prefixes)
+static size_t parseMemorySize(const std::string& str) {
+  std::size_t pos = 0;
+  double value = std::stod(str, &pos);
+  std::string unit = boost::to_upper_copy(str.substr(pos));
+  boost::trim(unit);
+  double factor = 1.0;
+  if(unit.empty() || unit == "B")
+    factor = 1.0;
+  else if(boost::starts_with(unit, "K"))
+    factor = 1024.0;
+  else if(boost::starts_with(unit, "M"))
+    factor = 1024.0*1024.0;
+  else if(boost::starts_with(unit, "G"))
+    factor = 1024.0*1024.0*1024.0;
+  else if(boost::starts_with(unit, "T"))
+    factor = 1024.0*1024.0*1024.0*1024.0;
+  else
+    throw std::invalid_argument(str);
+  if(value < 0.0)
+    throw std::invalid_argument(str);
+  return static_cast<size_t>(value*factor);
+}
+
 void OptionsDefault::parseFile(const std::string& file) {
   std::ifstream f(file);
   std::string line;
@@ -51,9 +108,30 @@ void OptionsDefault::parseFile(const std::string& file) {
   }
 }
 
-void OptionsDefault::parseExtent( const std::string& extent ) {
+void OptionsDefault::parseExtent( const std::string& extent_budget ) {
+  // optional planning time budget: <extent>:<seconds>
+  std::string extent = extent_budget;
+  double budget = -1.0;
+  auto colon = extent_budget.find(':');
+  if(colon != std::string::npos) {
+    extent = extent_budget.substr(0, colon);
+    try {
+      budget = std::stod(extent_budget.substr(colon+1));
+    } catch(const std::logic_error&) {
+      budget = -1.0;
+    }
+    if(budget <= 0.0)
+      throw po::validation_error(po::validation_error::invalid_option_value,
+                                 "extent", extent_budget);
+  }
   std::vector<std::string> token;
   boost::split(token, extent, boost::is_any_of("x,"));
+  if(budget > 0.0) {
+    std::vector<size_t> key;
+    for(const auto& t : token)
+      key.push_back(std::stoull(t));
+    planBudgets_[key] = budget;
+  }
   if(token.size()==1) {
     Extents1D array = {std::stoull(token[0])};
     vector1D_.push_back( array );
@@ -69,6 +147,37 @@ void OptionsDefault::parseExtent( const std::string& extent ) {
   }
 }
 
+template<typename T_Extents>
+static void addExtent(std::vector<T_Extents>& list, const std::vector<size_t>& extent) {
+  T_Extents array;
+  std::copy(extent.begin(), extent.end(), array.begin());
+  if(std::find(list.begin(), list.end(), array) == list.end())
+    list.push_back(array);
+}
+
+template<typename T_Extents>
+static void addOrigins(std::vector<std::vector<size_t> >& origins, const std::vector<T_Extents>& list) {
+  for(const auto& e : list)
+    origins.emplace_back(e.begin(), e.end());
+}
+
+void OptionsDefault::addPaddedExtents() {
+  paddingOrigins_.clear();
+  addOrigins(paddingOrigins_, vector1D_);
+  addOrigins(paddingOrigins_, vector2D_);
+  addOrigins(paddingOrigins_, vector3D_);
+  for(const auto& origin : paddingOrigins_) {
+    for(const auto& padded : PaddingAdvisor::padded(origin, advisePadding_)) {
+      if(origin.size()==1)
+        addExtent(vector1D_, padded.second);
+      else if(origin.size()==2)
+        addExtent(vector2D_, padded.second);
+      else
+        addExtent(vector3D_, padded.second);
+    }
+  }
+}
+
 /// processes command line arguments and apply the values to the variables
 int OptionsDefault::parse(std::vector<char*>& _argv, std::vector<char*>& _boost_vargv) {
 
@@ -104,6 +213,60 @@ int OptionsDefault::parse(std::vector<char*>& _argv, std::vector<char*>& _boost_
     }else{
       verbose_ = false;
     }
+    if( vm.count("memory-budget") ) {
+      auto budget = vm["memory-budget"].as<std::string>();
+      if( budget == "auto" ) {
+        // available memory is read once, not per benchmark
+        memoryBudget_ = autoMemoryBudget();
+      } else {
+        try {
+          memoryBudget_ = static_cast<long long>(parseMemorySize(budget));
+        } catch(const std::logic_error&) {
+          throw po::validation_error(po::validation_error::invalid_option_value,
+                                     "memory-budget", budget);
+        }
+        if( memoryBudget_ == 0 ) // would skip all benchmarks
+          throw po::validation_error(po::validation_error::invalid_option_value,
+                                     "memory-budget", budget);
+      }
+    }
+    if( vm.count("data-cache") ) {
+      auto cache = vm["data-cache"].as<std::string>();
+      if( cache == "auto" ) {
+        dataCache_ = -1;
+      } else {
+        try {
+          dataCache_ = static_cast<long long>(parseMemorySize(cache));
+        } catch(const std::logic_error&) {
+          throw po::validation_error(po::validation_error::invalid_option_value,
+                                     "data-cache", cache);
+        }
+      }
+    }
+    if( vm.count("max-bytes") ) {
+      auto bytes = vm["max-bytes"].as<std::string>();
+      try {
+        maxBytes_ = parseMemorySize(bytes);
+      } catch(const std::logic_error&) {
+        throw po::validation_error(po::validation_error::invalid_option_value,
+                                   "max-bytes", bytes);
+      }
+    }
+    dryRun_ = vm.count("dry-run") > 0;
+    {
+      auto ftz = vm["ftz-daz"].as<std::string>();
+      if( ftz != "off" && ftz != "on" && ftz != "both" )
+        throw po::validation_error(po::validation_error::invalid_option_value,
+                                   "ftz-daz", ftz);
+    }
+    try {
+      validation_ = ValidationPolicy(vm["validate"].as<std::string>(),
+                                     vm["validate-confidence"].as<double>(),
+                                     vm["validate-rate"].as<double>());
+    } catch(const std::runtime_error&) {
+      throw po::validation_error(po::validation_error::invalid_option_value,
+                                 "validate", vm["validate"].as<std::string>());
+    }
     if( vm.count("list-devices")  ) {
       listDevices_ = true;
       return 1;
@@ -123,6 +286,13 @@ int OptionsDefault::parse(std::vector<char*>& _argv, std::vector<char*>& _boost_
         parseExtent("32x32x32");
       }
     }
+    if( vm.count("advise-padding") ) {
+      advisePadding_ = vm["advise-padding"].as<double>();
+      if( advisePadding_ <= 0.0 )
+        throw po::validation_error(po::validation_error::invalid_option_value,
+                                   "advise-padding", std::to_string(advisePadding_));
+      addPaddedExtents();
+    }
 
     // use Boost command line arguments
     if( vm.count("list-benchmarks") ){
@@ -0,0 +1,153 @@
+/**
+ * check_csv - checks the rows of a gearshifft result file.
+ *
+ * Usage: check_csv <result.csv> <check>...
+ *
+ * A check is a list of conditions joined by '&', which are evaluated per row:
+ *   <conds>       at least one row fulfills all conditions
+ *   !<conds>      no row fulfills all conditions
+ *   #<N>:<conds>  exactly N rows fulfill all conditions
+ * A condition compares a column, which is looked up by its header name:
+ *   column=value  column!=value  column~substring  column>number  column<number
+ * e.g. "benchmark=Inplace_Complex&success=Success" or "!success~Error".
+ */
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+  using Row = std::vector<std::string>;
+
+  /// splits csv line, removes quotes
+  Row splitCSV(const std::string& line) {
+    Row tokens(1);
+    bool quoted = false;
+    for(char c : line) {
+      if(c=='"')
+        quoted = !quoted;
+      else if(c==',' && !quoted)
+        tokens.emplace_back();
+      else
+        tokens.back() += c;
+    }
+    return tokens;
+  }
+
+  struct Condition {
+    size_t column;
+    std::string op;
+    std::string value;
+
+    bool operator()(const Row& row) const {
+      const std::string& v = column < row.size() ? row[column] : std::string();
+      if(op=="=")
+        return v==value;
+      if(op=="!=")
+        return v!=value;
+      if(op=="~")
+        return v.find(value)!=std::string::npos;
+      double x = std::strtod(v.c_str(), nullptr);
+      double y = std::strtod(value.c_str(), nullptr);
+      return op==">" ? x>y : x<y;
+    }
+  };
+
+  struct Check {
+    std::string text;
+    bool negate = false;
+    long count = -1; // -1 = at least one row
+    std::vector<Condition> conditions;
+
+    bool matches(const Row& row) const {
+      for(const auto& c : conditions)
+        if(!c(row))
+          return false;
+      return true;
+    }
+  };
+
+  Check parseCheck(const std::string& text, const std::map<std::string,size_t>& header) {
+    Check check;
+    check.text = text;
+    std::string conds = text;
+    if(!conds.empty() && conds[0]=='!') {
+      check.negate = true;
+      conds.erase(0,1);
+    } else if(!conds.empty() && conds[0]=='#') {
+      auto colon = conds.find(':');
+      if(colon==std::string::npos)
+        throw std::runtime_error("Missing ':' after row count in check '"+text+"'.");
+      check.count = std::stol(conds.substr(1, colon-1));
+      conds.erase(0, colon+1);
+    }
+    size_t begin = 0;
+    while(begin <= conds.size()) {
+      size_t end = conds.find('&', begin);
+      if(end==std::string::npos)
+        end = conds.size();
+      std::string cond = conds.substr(begin, end-begin);
+      size_t pos = cond.find_first_of("!=~<>");
+      if(pos==std::string::npos || pos==0)
+        throw std::runtime_error("Invalid condition '"+cond+"' in check '"+text+"'.");
+      Condition c;
+      c.op = cond[pos]=='!' ? "!=" : cond.substr(pos,1);
+      auto name = cond.substr(0, pos);
+      auto it = header.find(name);
+      if(it==header.end())
+        throw std::runtime_error("Unknown column '"+name+"' in check '"+text+"'.");
+      c.column = it->second;
+      c.value = cond.substr(pos+c.op.size());
+      check.conditions.push_back(c);
+      begin = end+1;
+    }
+    return check;
+  }
+}
+
+int main(int argc, char* argv[]) {
+  if(argc < 3) {
+    std::cerr << "Usage: " << argv[0] << " <result.csv> <check>..." << std::endl;
+    return EXIT_FAILURE;
+  }
+  try {
+    std::ifstream fs(argv[1]);
+    if(!fs.good())
+      throw std::runtime_error(std::string("Could not open result file '")+argv[1]+"'.");
+
+    std::map<std::string,size_t> header;
+    std::vector<Row> rows;
+    std::string line;
+    while(std::getline(fs, line)) {
+      if(line.empty() || line[0]==';')
+        continue;
+      auto tokens = splitCSV(line);
+      if(header.empty()) {
+        for(size_t i=0; i<tokens.size(); ++i)
+          header[tokens[i]] = i;
+      } else {
+        rows.push_back(tokens);
+      }
+    }
+
+    int failed = 0;
+    for(int i=2; i<argc; ++i) {
+      auto check = parseCheck(argv[i], header);
+      long n = 0;
+      for(const auto& row : rows)
+        n += check.matches(row) ? 1 : 0;
+      bool ok = check.negate ? n==0 : check.count<0 ? n>0 : n==check.count;
+      std::cout << (ok ? "passed: " : "FAILED: ") << check.text
+                << " (" << n << " of " << rows.size() << " rows)" << std::endl;
+      failed += ok ? 0 : 1;
+    }
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+  } catch(const std::exception& e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,154 @@
+#define BOOST_TEST_MODULE TestBuiltin
+
+#include "libraries/builtin/stockham.hpp"
+#include <boost/test/included/unit_test.hpp> // Single-header usage variant
+#include <cmath>
+#include <complex>
+#include <vector>
+
+using gearshifft::builtin::Transform;
+
+/// naive DFT along each dimension of a row-major array
+std::vector<std::complex<double> > dft(std::vector<std::complex<double> > x,
+                                       const std::vector<size_t>& extents,
+                                       int sign) {
+  const double pi = std::acos(-1.0);
+  size_t inner = x.size();
+  size_t outer = 1;
+  for(size_t n : extents) {
+    inner /= n;
+    std::vector<std::complex<double> > y(x.size());
+    for(size_t o = 0; o < outer; ++o)
+      for(size_t c = 0; c < inner; ++c)
+        for(size_t k = 0; k < n; ++k)
+          for(size_t j = 0; j < n; ++j)
+            y[(o*n+k)*inner+c] += x[(o*n+j)*inner+c]
+              * std::polar(1.0, sign*2.0*pi*static_cast<double>(j*k%n)/static_cast<double>(n));
+    x = y;
+    outer *= n;
+  }
+  return x;
+}
+
+std::vector<std::vector<size_t> > extents_list() {
+  return {{1}, {2}, {7}, {12}, {30}, {45}, {64}, {77}, {100}, {128}, {5,7}, {6,10}, {3,8,4}, {16,16}};
+}
+
+BOOST_AUTO_TEST_CASE( C2C )
+{
+  const double eps = 1e-9;
+  for(const auto& extents : extents_list()) {
+    size_t n = 1;
+    for(size_t e : extents)
+      n *= e;
+    std::vector<std::complex<double> > x(n);
+    std::vector<double> data(2*n), out(2*n);
+    for(size_t i = 0; i < n; ++i) {
+      x[i] = {static_cast<double>(i%7)/6, static_cast<double>(i%5)/4};
+      data[i] = x[i].real();
+      data[n+i] = x[i].imag();
+    }
+    Transform<double> fwd(extents, false, -1);
+    std::vector<double> scratch(fwd.scratch_size());
+    fwd.execute(data.data(), out.data(), scratch.data());
+    const auto y = dft(x, extents, -1);
+    for(size_t i = 0; i < n; ++i) {
+      BOOST_TEST( std::abs(out[i] - y[i].real()) < eps );
+      BOOST_TEST( std::abs(out[n+i] - y[i].imag()) < eps );
+    }
+    // in-place inverse
+    Transform<double> bwd(extents, false, 1);
+    bwd.execute(out.data(), out.data(), scratch.data());
+    for(size_t i = 0; i < 2*n; ++i)
+      BOOST_TEST( std::abs(out[i]/static_cast<double>(n) - data[i]) < eps );
+  }
+}
+
+BOOST_AUTO_TEST_CASE( R2C )
+{
+  const double eps = 1e-9;
+  for(const auto& extents : extents_list()) {
+    size_t n = 1;
+    for(size_t e : extents)
+      n *= e;
+    const size_t len = extents.back();
+    const size_t clen = len/2+1;
+    const size_t nc = n/len*clen;
+    std::vector<std::complex<double> > x(n);
+    std::vector<double> data(n), out(2*nc);
+    for(size_t i = 0; i < n; ++i) {
+      data[i] = static_cast<double>(i%7)/6;
+      x[i] = data[i];
+    }
+    Transform<double> fwd(extents, true, -1);
+    Transform<double> bwd(extents, true, 1);
+    std::vector<double> scratch(fwd.scratch_size());
+    fwd.execute(data.data(), out.data(), scratch.data());
+    const auto y = dft(x, extents, -1);
+    for(size_t row = 0; row < n/len; ++row) {
+      for(size_t k = 0; k < clen; ++k) {
+        BOOST_TEST( std::abs(out[row*clen+k] - y[row*len+k].real()) < eps );
+        BOOST_TEST( std::abs(out[nc+row*clen+k] - y[row*len+k].imag()) < eps );
+      }
+    }
+    std::vector<double> result(n);
+    bwd.execute(out.data(), result.data(), scratch.data());
+    for(size_t i = 0; i < n; ++i)
+      BOOST_TEST( std::abs(result[i]/static_cast<double>(n) - data[i]) < eps );
+  }
+}
+
+BOOST_AUTO_TEST_CASE( R2CSingle )
+{
+  const float eps = 1e-4f;
+  const std::vector<size_t> extents = {16, 30};
+  const size_t n = 16*30;
+  std::vector<float> data(n), out(2*16*16), result(n);
+  for(size_t i = 0; i < n; ++i)
+    data[i] = static_cast<float>(i%7)/6;
+  Transform<float> fwd(extents, true, -1);
+  Transform<float> bwd(extents, true, 1);
+  std::vector<float> scratch(fwd.scratch_size());
+  fwd.execute(data.data(), out.data(), scratch.data());
+  bwd.execute(out.data(), result.data(), scratch.data());
+  for(size_t i = 0; i < n; ++i)
+    BOOST_TEST( std::abs(result[i]/static_cast<float>(n) - data[i]) < eps );
+}
+
+BOOST_AUTO_TEST_CASE( BatchCodelets )
+{
+  const double eps = 1e-9;
+  const size_t batch = 19;
+  for(const auto& extents : extents_list()) {
+    for(bool real : {false, true}) {
+      size_t n = 1;
+      for(size_t e : extents)
+        n *= e;
+      const size_t nc = real ? n/extents.back()*(extents.back()/2+1) : n;
+      const size_t in_len = real ? n : 2*n;
+      std::vector<double> data(in_len*batch), out(2*nc*batch);
+      for(size_t i = 0; i < in_len; ++i)
+        for(size_t b = 0; b < batch; ++b)
+          data[i*batch+b] = std::sin(0.37*static_cast<double>(i) + static_cast<double>(b));
+      // interleaved batch with codelets
+      Transform<double> fwd(extents, real, -1, batch, true);
+      std::vector<double> scratch(fwd.scratch_size());
+      fwd.execute(data.data(), out.data(), scratch.data());
+      // single transforms without codelets
+      Transform<double> ref(extents, real, -1, 1, false);
+      std::vector<double> x(in_len), y(2*nc), ref_scratch(ref.scratch_size());
+      for(size_t b = 0; b < batch; ++b) {
+        for(size_t i = 0; i < in_len; ++i)
+          x[i] = data[i*batch+b];
+        ref.execute(x.data(), y.data(), ref_scratch.data());
+        for(size_t i = 0; i < 2*nc; ++i)
+          BOOST_TEST( std::abs(out[i*batch+b] - y[i]) < eps );
+      }
+      Transform<double> bwd(extents, real, 1, batch, true);
+      std::vector<double> result(in_len*batch);
+      bwd.execute(out.data(), result.data(), scratch.data());
+      for(size_t i = 0; i < in_len*batch; ++i)
+        BOOST_TEST( std::abs(result[i]/static_cast<double>(n) - data[i]) < eps );
+    }
+  }
+}
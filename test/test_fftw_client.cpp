@@ -0,0 +1,63 @@
+#define BOOST_TEST_MODULE TestFFTWClient
+
+#include "libraries/fftw/fftw.hpp"
+#include <boost/test/included/unit_test.hpp> // Single-header usage variant
+#include <stdexcept>
+
+using namespace gearshifft::fftw;
+
+#ifndef USE_ESSL
+BOOST_AUTO_TEST_CASE( R2RLogicalSize )
+{
+  BOOST_TEST( traits::r2r_logical_size(FFTW_REDFT10, 8) == 16u );
+  BOOST_TEST( traits::r2r_logical_size(FFTW_RODFT11, 8) == 16u );
+  BOOST_TEST( traits::r2r_logical_size(FFTW_REDFT00, 8) == 14u );
+  BOOST_TEST( traits::r2r_logical_size(FFTW_REDFT00, 2) == 2u );
+  BOOST_TEST( traits::r2r_logical_size(FFTW_RODFT00, 8) == 18u );
+  BOOST_TEST( traits::r2r_logical_size(FFTW_DHT, 8) == 8u );
+  // DCT-I of a single point has logical size 0
+  BOOST_CHECK_THROW( traits::r2r_logical_size(FFTW_REDFT00, 1), std::runtime_error );
+}
+
+BOOST_AUTO_TEST_CASE( R2RInverse )
+{
+  BOOST_TEST( traits::r2r_inverse(FFTW_REDFT10) == FFTW_REDFT01 );
+  BOOST_TEST( traits::r2r_inverse(FFTW_REDFT01) == FFTW_REDFT10 );
+  BOOST_TEST( traits::r2r_inverse(FFTW_RODFT10) == FFTW_RODFT01 );
+  BOOST_TEST( traits::r2r_inverse(FFTW_REDFT00) == FFTW_REDFT00 );
+  BOOST_TEST( traits::r2r_inverse(FFTW_DHT) == FFTW_DHT );
+}
+
+/// round trip of the R2R client is scaled by the product of the logical sizes
+BOOST_AUTO_TEST_CASE( R2RNormalization, * boost::unit_test::tolerance(1e-12) )
+{
+  using R2R = FftwImpl<gearshifft::FFT_Outplace_R2R, float, 2>;
+  FftwContext::select_variant("r2r=redft10");
+  BOOST_TEST( R2R::normalization({{4, 6}}) == 8.0*12.0 );
+  BOOST_TEST( R2R::unsupported({{4, 1}}).empty() );
+  FftwContext::select_variant("r2r=redft00");
+  BOOST_TEST( R2R::normalization({{4, 6}}) == 6.0*10.0 );
+  BOOST_TEST( !R2R::unsupported({{4, 1}}).empty() );
+  BOOST_TEST( R2R::unsupported({{4, 2}}).empty() );
+  FftwContext::select_variant("");
+}
+#endif
+
+BOOST_AUTO_TEST_CASE( AxesMask )
+{
+  BOOST_TEST( FftwContext::axes_mask("last", 3) == 4u );
+  BOOST_TEST( FftwContext::axes_mask("first+last", 2) == 3u );
+  BOOST_TEST( FftwContext::axes_mask("0+2", 3) == 5u );
+  BOOST_CHECK_THROW( FftwContext::axes_mask("2", 2), std::runtime_error );
+  BOOST_CHECK_THROW( FftwContext::axes_mask("10", 3), std::runtime_error );
+  BOOST_CHECK_THROW( FftwContext::axes_mask("0+", 3), std::runtime_error );
+  BOOST_CHECK_THROW( FftwContext::axes_mask("x", 3), std::runtime_error );
+  BOOST_TEST( FftwContext::axes_exist("0+1", 2) );
+  BOOST_TEST( !FftwContext::axes_exist("2", 2) );
+}
+
+// fftw.hpp includes the benchmark executor, which customizes the entry point
+int main(int argc, char* argv[])
+{
+  return boost::unit_test::unit_test_main(&init_unit_test, argc, argv);
+}